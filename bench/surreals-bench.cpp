@@ -0,0 +1,247 @@
+///
+/// Benchmarks for construction, comparison, arithmetic, display, SurrealInf terms and genesis.
+///
+/// Every benchmark is run for a few parameters (usually the birthday of its operands) and, where the lookup
+/// tables matter, both cold (the tables are cleared before every operation) and warm (the operation was done once
+/// before timing). Results are written as JSON, to stdout or to the file given with --out.
+///
+/// Usage: surreals-bench [--filter <substring>] [--min-time <seconds>] [--out <file>]
+///
+
+#include "../surreals.h"
+#include "../genesis.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace surreals;
+
+/// Results are written here, so the compiler can not drop the work
+static volatile float sink;
+
+struct Result {
+    std::string name;
+    int param;
+    std::string memo; /// "cold", "warm" or "none"
+    std::size_t iterations;
+    double meanNs;
+    double minNs;
+    double medianNs;
+};
+
+class Bench {
+public:
+    Bench(std::string filter, double minTime) : filter(std::move(filter)), minTime(minTime) {}
+
+    /// Time body until minTime has been spent in it. With a setup (cold runs), every operation is timed on its own,
+    /// after the setup; otherwise operations are timed in batches, so short ones are not swamped by the clock.
+    void Run(std::string const &name, int param, std::string const &memo,
+             std::function<void()> const &setup, std::function<void()> const &body) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) { return; }
+        std::cerr << name << " " << param << " " << memo << "..." << std::endl;
+
+        std::vector<double> samples; /// nanoseconds per operation
+        std::size_t iterations = 0;
+        double total = 0;
+
+        if (setup) {
+            while (total < minTime * 1e9 || samples.size() < 3) {
+                setup();
+                auto start = Clock::now();
+                body();
+                double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                samples.push_back(ns);
+                total += ns;
+                iterations++;
+            }
+        } else {
+            body(); /// warm up
+            std::size_t batch = 1;
+            while (true) { /// grow the batch until it takes a tenth of the time
+                double ns = TimeBatch(body, batch);
+                if (ns >= minTime * 1e8 || batch >= (std::size_t(1) << 30)) { break; }
+                batch *= 2;
+            }
+            for (int i = 0; i < 10; i++) {
+                double ns = TimeBatch(body, batch);
+                samples.push_back(ns / (double) batch);
+                total += ns;
+                iterations += batch;
+            }
+        }
+
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        results.push_back({name, param, memo, iterations, total / (double) iterations, sorted.front(),
+                           sorted[sorted.size() / 2]});
+    }
+
+    /// The document is formatted on a stream of its own, so the format flags of `output` are left alone
+    void WriteJson(std::ostream &output) const {
+        std::ostringstream out;
+        out << "{\n  \"context\": {\"min_time_s\": " << minTime << ", \"hardware_threads\": "
+            << std::thread::hardware_concurrency() << "},\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            Result const &r = results[i];
+            out << (i ? ",\n" : "\n") << std::fixed << std::setprecision(1)
+                << "    {\"name\": \"" << r.name << "\", \"param\": " << r.param << ", \"memo\": \"" << r.memo
+                << "\", \"iterations\": " << r.iterations << ", \"mean_ns\": " << r.meanNs
+                << ", \"min_ns\": " << r.minNs << ", \"median_ns\": " << r.medianNs << "}";
+        }
+        out << "\n  ]\n}\n";
+        output << out.str();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static double TimeBatch(std::function<void()> const &body, std::size_t batch) {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; i++) { body(); }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    std::string filter;
+    double minTime;
+    std::vector<Result> results;
+};
+
+static void ClearLookups() {
+    Surreal::AddLookup.clear();
+    Surreal::MultLookup.clear();
+}
+
+/// A number born on the given day (at least 2): the one three quarters of the way through the day
+static Surreal NumberBornOn(int day) {
+    return GenesisRange::Nth(day, (std::uint64_t(3) << day) / 4).ToSurreal();
+}
+
+/// Another number born on the same day, five eighths of the way through it
+static Surreal OtherNumberBornOn(int day) {
+    return GenesisRange::Nth(day, (std::uint64_t(5) << day) / 8).ToSurreal();
+}
+
+/// Run a lookup-table dependent benchmark cold and warm
+static void RunMemo(Bench &bench, std::string const &name, int param, std::function<void()> const &body) {
+    bench.Run(name, param, "cold", ClearLookups, body);
+    ClearLookups();
+    bench.Run(name, param, "warm", nullptr, body);
+}
+
+int main(int argc, char **argv) {
+    std::string filter, outPath;
+    double minTime = 0.1;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) { filter = argv[++i]; }
+        else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) { minTime = std::atof(argv[++i]); }
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) { outPath = argv[++i]; }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--min-time <seconds>] [--out <file>]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    Bench bench(filter, minTime);
+
+    /// Construction
+    for (int n : {1, 8, 32}) {
+        bench.Run("construct_int", n, "none", nullptr, [n]() {
+            sink = (float) Surreal(n).left.size();
+        });
+    }
+    for (int day : {4, 8, 12}) {
+        float value = NumberBornOn(day).Float();
+        bench.Run("construct_float", day, "none", nullptr, [value]() {
+            sink = (float) Surreal(value).left.size();
+        });
+    }
+
+    /// Comparison, conversion and display
+    for (int day : {4, 8, 12}) {
+        Surreal a = NumberBornOn(day), b = OtherNumberBornOn(day);
+        bench.Run("compare", day, "none", nullptr, [&a, &b]() {
+            sink = (float) (a <= b);
+        });
+        bench.Run("float", day, "none", nullptr, [&a]() {
+            sink = a.Float();
+        });
+        bench.Run("print", day, "none", nullptr, [&a, day]() {
+            sink = (float) a.Print(day).size();
+        });
+    }
+
+    /// Arithmetic
+    for (int day : {3, 5, 7}) {
+        Surreal a = NumberBornOn(day), b = OtherNumberBornOn(day);
+        RunMemo(bench, "add", day, [&a, &b]() {
+            sink = (float) (a + b).left.size();
+        });
+    }
+    for (int day : {2, 3, 4}) {
+        Surreal a = NumberBornOn(day), b = OtherNumberBornOn(day);
+        RunMemo(bench, "multiply", day, [&a, &b]() {
+            sink = (float) (a * b).left.size();
+        });
+    }
+
+    /// SurrealInf terms: cold on a fresh number, warm once the term is cached
+    std::function<SurrealInf(int)> naturals = [](int n) { return SurrealInf(n); };
+    for (int n : {10, 100}) {
+        std::shared_ptr<SurrealInf> omega;
+        bench.Run("surrealinf_term", n, "cold", [&omega, &naturals]() {
+            omega = std::make_shared<SurrealInf>(naturals, nullptr, std::make_pair(-1, 0));
+        }, [&omega, n]() {
+            sink = (float) omega->getLeft(n).leftSize;
+        });
+        bench.Run("surrealinf_term", n, "warm", nullptr, [&omega, n]() {
+            sink = (float) omega->getLeft(n).leftSize;
+        });
+    }
+
+    /// Genesis
+    for (int day : {10, 16, 20}) {
+        bench.Run("genesis", day, "none", nullptr, [day]() {
+            Genesis genesis;
+            genesis.AdvanceTo(day);
+            sink = (float) genesis.Size();
+        });
+    }
+    for (int day : {16, 20}) {
+        bench.Run("genesis_range", day, "none", nullptr, [day]() {
+            double sum = 0;
+            for (Dyadic const &value : GenesisRange::BornOn(day)) { sum += value.Double(); }
+            sink = (float) sum;
+        });
+    }
+    for (int day : {4, 5}) {
+        bench.Run("closure_genesis", day, "none", nullptr, [day]() {
+            ClosureGenesis genesis;
+            genesis.AdvanceTo(day);
+            sink = (float) genesis.Size();
+        });
+    }
+
+    if (outPath.empty()) {
+        bench.WriteJson(std::cout);
+    } else {
+        std::ofstream out(outPath);
+        bench.WriteJson(out);
+        if (!out) {
+            std::cerr << "Failed to write " << outPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+///
+/// Implementations for the complete arithmetic tables.
+///
+
+#include "closuretable.h"
+#include "genesis.h"
+#include "parallel.h"
+
+#include <unordered_map>
+
+namespace surreals {
+
+    /// Cells are handled in square tiles of this side, which keeps the rows a tile touches in cache
+    static const std::size_t TileSize = 64;
+
+    ClosureTable::ClosureTable(Operation operation, int day, unsigned threads) : operation(operation), day(day) {
+        if (day < 0 || day > 15) { throw std::runtime_error("Closure tables are only built for days 0 to 15!"); }
+
+        Genesis genesis;
+        genesis.AdvanceTo(day);
+        operands = genesis.Known();
+        std::size_t n = operands.size();
+
+        /// the tiles on or above the diagonal, which hold every computed cell
+        std::size_t tilesPerSide = (n + TileSize - 1) / TileSize;
+        std::vector<std::pair<std::size_t, std::size_t>> tiles;
+        for (std::size_t ti = 0; ti < tilesPerSide; ti++) {
+            for (std::size_t tj = ti; tj < tilesPerSide; tj++) { tiles.emplace_back(ti, tj); }
+        }
+        auto forEachComputed = [this, n, &tiles](std::size_t tile, auto const &body) {
+            std::size_t iEnd = std::min(n, (tiles[tile].first + 1) * TileSize);
+            std::size_t jEnd = std::min(n, (tiles[tile].second + 1) * TileSize);
+            for (std::size_t i = tiles[tile].first * TileSize; i < iEnd; i++) {
+                for (std::size_t j = tiles[tile].second * TileSize; j < jEnd; j++) {
+                    if (Computed(i, j)) { body(i, j); }
+                }
+            }
+        };
+
+        /// first pass: the distinct results of every tile
+        std::vector<std::vector<Dyadic>> found(tiles.size());
+        ParallelFor(tiles.size(), threads, [this, &found, &forEachComputed](std::size_t tile) {
+            std::vector<Dyadic> &local = found[tile];
+            forEachComputed(tile, [this, &local](std::size_t i, std::size_t j) {
+                local.push_back(Apply(operands[i], operands[j]));
+            });
+            std::sort(local.begin(), local.end());
+            local.erase(std::unique(local.begin(), local.end()), local.end());
+        });
+
+        /// the results of the other cells are the same values or their negations
+        for (std::vector<Dyadic> &local : found) {
+            for (Dyadic const &value : local) {
+                results.push_back(value);
+                results.push_back(-value);
+            }
+            std::vector<Dyadic>().swap(local);
+        }
+        std::sort(results.begin(), results.end());
+        results.erase(std::unique(results.begin(), results.end()), results.end());
+
+        std::unordered_map<Dyadic, std::uint32_t, DyadicHash> ranks;
+        ranks.reserve(results.size());
+        for (std::size_t r = 0; r < results.size(); r++) { ranks.emplace(results[r], (std::uint32_t) r); }
+
+        /// second pass: every class of cells gets the rank of its computed cell, each class is written by one tile
+        cells.resize(n * n);
+        ParallelFor(tiles.size(), threads, [this, &ranks, &forEachComputed](std::size_t tile) {
+            forEachComputed(tile, [this, &ranks](std::size_t i, std::size_t j) {
+                Fill(i, j, ranks.find(Apply(operands[i], operands[j]))->second);
+            });
+        });
+    }
+
+    /// Operands of rank i and N - 1 - i are negations of each other, and N is odd, so the rank of 0 is (N - 1) / 2.
+    /// Sums are computed for i <= j with i + j <= N - 1; products for i <= j with both operands not negative.
+    bool ClosureTable::Computed(std::size_t i, std::size_t j) const {
+        std::size_t last = operands.size() - 1;
+        if (i > j) { return false; }
+        if (operation == Operation::Sum) { return i + j <= last; }
+        return i >= last / 2;
+    }
+
+    /// Results are closed under negation, so the rank of -r is (amount of results) - 1 - (rank of r)
+    void ClosureTable::Fill(std::size_t i, std::size_t j, std::uint32_t rank) {
+        std::size_t n = operands.size(), last = n - 1;
+        std::uint32_t negated = (std::uint32_t) (results.size() - 1) - rank;
+        auto set = [this, n](std::size_t a, std::size_t b, std::uint32_t value) {
+            cells[a * n + b] = value;
+            cells[b * n + a] = value;
+        };
+
+        set(i, j, rank);
+        if (operation == Operation::Sum) {
+            set(last - i, last - j, negated);
+        } else {
+            set(last - i, j, negated);
+            set(i, last - j, negated);
+            set(last - i, last - j, rank);
+        }
+    }
+
+    Dyadic ClosureTable::Apply(Dyadic const &a, Dyadic const &b) const {
+        return (operation == Operation::Sum) ? a + b : a * b;
+    }
+
+    ClosureTable::Operation ClosureTable::GetOperation() const {
+        return operation;
+    }
+
+    int ClosureTable::Day() const {
+        return day;
+    }
+
+    std::vector<Dyadic> const &ClosureTable::Operands() const {
+        return operands;
+    }
+
+    std::vector<Dyadic> const &ClosureTable::Results() const {
+        return results;
+    }
+
+    std::uint32_t ClosureTable::Rank(std::size_t i, std::size_t j) const {
+        return cells[i * operands.size() + j];
+    }
+
+    Dyadic const &ClosureTable::At(std::size_t i, std::size_t j) const {
+        return results[Rank(i, j)];
+    }
+
+    std::vector<std::uint32_t> const &ClosureTable::Cells() const {
+        return cells;
+    }
+
+}
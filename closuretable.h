@@ -0,0 +1,76 @@
+///
+/// Complete addition and multiplication tables for the numbers born by some day.
+///
+/// The numbers born by day k are ranked 0 .. N - 1 in increasing order, where N = 2^(k+1) - 1, so rank i and
+/// rank N - 1 - i hold a number and its negation. A table is a dense N x N array of uint32: the cell (i, j) holds
+/// the rank of (operand i) + (operand j), or (operand i) * (operand j), among the distinct results of the table,
+/// which are kept in increasing order alongside it.
+///
+/// Only one cell of every class of cells known to be equal (up to negation) is computed:
+///     sums:      a + b = b + a, and (-a) + (-b) = -(a + b)
+///     products:  a * b = b * a, and (-a) * b = a * (-b) = -(a * b)
+/// which is about a quarter of the sums and an eighth of the products. The arithmetic is exact (on Dyadic
+/// values), and the computed part is split into square tiles that are handled on a pool of threads.
+///
+/// The array takes 4 * N^2 bytes: 16 MB for day 10, 256 MB for day 12.
+///
+
+#ifndef SURREALS_CLOSURETABLE_H
+#define SURREALS_CLOSURETABLE_H
+
+#include "dyadic.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace surreals {
+
+    /// The table of an operation over the numbers born by some day
+    class ClosureTable {
+    public:
+        enum class Operation {
+            Sum, Product
+        };
+
+        /// Compute the table for the numbers born by the given day (at most 15, so ranks fit), on a pool of threads
+        /// (0 picks the amount of hardware threads)
+        ClosureTable(Operation operation, int day, unsigned threads);
+
+        Operation GetOperation() const;
+
+        int Day() const;
+
+        /// The numbers born by Day(), in increasing order: the operand of rank i is Operands()[i]
+        std::vector<Dyadic> const &Operands() const;
+
+        /// The distinct results, in increasing order
+        std::vector<Dyadic> const &Results() const;
+
+        /// The rank among Results() of operand i combined with operand j
+        std::uint32_t Rank(std::size_t i, std::size_t j) const;
+
+        /// The value of operand i combined with operand j
+        Dyadic const &At(std::size_t i, std::size_t j) const;
+
+        /// The whole array, row by row
+        std::vector<std::uint32_t> const &Cells() const;
+
+    private:
+        /// Whether (i, j) is the cell computed for its class
+        bool Computed(std::size_t i, std::size_t j) const;
+
+        /// Write the rank of the computed cell (i, j) into every cell of its class
+        void Fill(std::size_t i, std::size_t j, std::uint32_t rank);
+
+        Dyadic Apply(Dyadic const &a, Dyadic const &b) const;
+
+        Operation operation;
+        int day;
+        std::vector<Dyadic> operands;
+        std::vector<Dyadic> results;
+        std::vector<std::uint32_t> cells;
+    };
+
+}
+
+#endif //SURREALS_CLOSURETABLE_H
@@ -1,4 +1,7 @@
 #include "../surreals.h"
+#include "../stats.h"
+#include "../trace.h"
+#include <fstream>
 #include <iostream>
 #include <string>
 
@@ -14,10 +17,24 @@ void Mult() {
 
         std::cout << "Multiplying... (this might take a while for numbers with depth > 10)" << std::endl;
 
-        Surreal res = aS * bS;
+        Surreal res;
+        if (Trace::Enabled()) {
+            std::ofstream traceFile("surreals-trace.json");
+            ChromeTraceWriter writer(traceFile);
+            Trace::SetSink(writer.Sink());
+            res = aS * bS;
+            Trace::SetSink(nullptr);
+            std::cout << std::endl << "Wrote a trace of the product to surreals-trace.json" << std::endl;
+        } else {
+            res = aS * bS;
+        }
 
         std::cout << std::endl << "result: " << res << std::endl;
 
+        if (Stats::Enabled()) {
+            std::cout << std::endl << "Statistics:" << std::endl << Stats::Snapshot().ToString() << std::endl;
+        }
+
         std::cout << "The addition table has "<< Surreal::AddLookup.size() << " entries. Print them out ? (y/n)" << std::endl;
         std::cin >> inp;
         if (inp == 'y') {
@@ -0,0 +1,57 @@
+#include "../surreals.h"
+#include "../memofile.h"
+#include <iostream>
+#include <string>
+
+using namespace surreals;
+
+/// Multiply a pair of integers, and tell how much of the work the base layer saved
+void Multiply(int a, int b) {
+    std::size_t before = Surreal::MultLookup.size();
+    Surreal res = Surreal(a) * Surreal(b);
+    std::cout << a << " * " << b << " = " << res.Float() << " (" << Surreal::MultLookup.size() - before
+              << " new multiplication table entries)" << std::endl;
+}
+
+void Report(std::string const &path) {
+    std::cout << path << " holds " << Surreal::LookupBase->NodeCount() << " nodes, "
+              << Surreal::LookupBase->SumCount() << " sums and " << Surreal::LookupBase->ProductCount()
+              << " products" << std::endl;
+}
+
+int main() {
+
+    std::cout << "This demo saves the lookup tables of a multiplication to a file, then starts again from it:" <<
+              std::endl << "the file is mapped back, another multiplication extends the tables, and they are" <<
+              std::endl << "saved to the same file while it is still mapped." <<
+              std::endl << std::endl;
+
+    std::cout << "Please input a file name, then two pairs of integers: " << std::endl;
+    std::string path;
+    int a, b, c, d;
+    if (!(std::cin >> path >> a >> b >> c >> d)) {
+        std::cout << "could not parse the input." << std::endl;
+        return 1;
+    }
+
+    Multiply(a, b);
+    MemoFile::Dump(path);
+
+    /// a fresh start: empty tables over the file
+    Surreal::AddLookup.clear();
+    Surreal::MultLookup.clear();
+    MemoFile::Load(path);
+    Report(path);
+
+    Multiply(a, b);
+    Multiply(c, d);
+    MemoFile::Dump(path); /// the file being replaced is still mapped as the base layer
+
+    /// the old mapping keeps working after the dump
+    Surreal::AddLookup.clear();
+    Surreal::MultLookup.clear();
+    Multiply(c, d);
+
+    MemoFile::Load(path);
+    Report(path);
+}
@@ -1,4 +1,5 @@
 #include "../surreals.h"
+#include "../normalform.h"
 #include <iostream>
 #include <string>
 
@@ -51,4 +52,30 @@ int main() {
     SurrealInf omega_plus_one = SurrealInf( [omega](int) { return omega; }, nullptr, std::make_pair(1, 0));
     std::cout << "printing Omega + 1 .." << std::endl;
     std::cout << omega_plus_one.Print(5, 1) << std::endl;
-}
\ No newline at end of file
+
+    /// arithmetic on SurrealInf is lazy: the generators of the result are only called when printing
+    SurrealInf omega_plus_one_sum = omega + SurrealInf(1);
+    std::cout << "printing Omega + 1 (computed by addition) .." << std::endl;
+    std::cout << omega_plus_one_sum.Print(3, 1) << std::endl;
+
+    SurrealInf omega_minus_one = omega - SurrealInf(1);
+    std::cout << "printing Omega - 1 (computed by subtraction) .." << std::endl;
+    std::cout << omega_minus_one.Print(3, 1) << std::endl;
+
+    /// numbers in Conway normal form are compared and added symbolically, without evaluating any terms
+    SurrealInf omega_nf = NormalForm::Omega().ToSurrealInf();
+    SurrealInf epsilon_nf = NormalForm::Epsilon().ToSurrealInf();
+    SurrealInf product = (omega_nf + SurrealInf(1)) * (omega_nf - epsilon_nf);
+
+    NormalForm product_nf;
+    NormalForm::FromSurrealInf(product, product_nf);
+    std::cout << "(Omega + 1) * (Omega - Epsilon) = " << product_nf << std::endl;
+    std::cout << "Omega + 1 > Omega ? " << (Compare(omega_nf + SurrealInf(1), omega_nf) == Ordering::Greater)
+              << std::endl;
+
+    /// sides given as closed-form sequences have exact values: { 1/2, 3/4, 7/8, ... | ..., 5/4, 9/8 } = 1
+    SurrealInf one_closed = SurrealInf(SurrealInf::Sequence::Geometric(1, -0.5),
+                                       SurrealInf::Sequence::Geometric(1, 0.5), std::make_pair(-1, -1));
+    std::cout << "printing One (from closed-form sequences) .." << std::endl;
+    std::cout << one_closed.Print(4, 0) << " = " << one_closed.Approximate(0.001f) << std::endl;
+}
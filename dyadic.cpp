@@ -0,0 +1,285 @@
+///
+/// Implementations for exact dyadic rationals.
+///
+
+#include "dyadic.h"
+
+namespace surreals {
+
+    /// Denominators stay below 2^63, so fractional parts always fit the numerator
+    static const int MaxExp = 62;
+
+    [[noreturn]] static void Overflow() {
+        throw std::overflow_error("Dyadic value out of range!");
+    }
+
+    /// value * 2^shift, checked
+    static std::int64_t Shift(std::int64_t value, int shift) {
+        if (shift == 0 || value == 0) { return value; }
+        std::int64_t bound = (shift >= 63) ? 0 : (std::numeric_limits<std::int64_t>::max() >> shift);
+        if (value > bound || value < -bound) { Overflow(); }
+        return value * ((std::int64_t) 1 << shift);
+    }
+
+    static std::int64_t Add(std::int64_t a, std::int64_t b) {
+        if ((b > 0 && a > std::numeric_limits<std::int64_t>::max() - b) ||
+            (b < 0 && a < std::numeric_limits<std::int64_t>::min() - b)) { Overflow(); }
+        return a + b;
+    }
+
+    static std::int64_t Multiply(std::int64_t a, std::int64_t b) {
+        if (a == 0 || b == 0) { return 0; }
+        if (a == std::numeric_limits<std::int64_t>::min() || b == std::numeric_limits<std::int64_t>::min()) {
+            Overflow();
+        }
+        std::int64_t absA = (a < 0) ? -a : a, absB = (b < 0) ? -b : b;
+        if (absA > std::numeric_limits<std::int64_t>::max() / absB) { Overflow(); }
+        return a * b;
+    }
+
+    Dyadic::Dyadic(std::int64_t integer) : num(integer), exp(0) {}
+
+    /// \param numerator: the numerator
+    /// \param exponent: the power of two in the denominator, may be negative
+    Dyadic::Dyadic(std::int64_t numerator, int exponent) : num(numerator), exp(exponent) {
+        if (exp < 0) {
+            num = Shift(num, -exp);
+            exp = 0;
+        }
+        Normalize();
+    }
+
+    void Dyadic::Normalize() {
+        if (num == 0) {
+            exp = 0;
+            return;
+        }
+        while (exp > 0 && (num & 1) == 0) {
+            num /= 2;
+            exp--;
+        }
+        if (exp > MaxExp) { Overflow(); }
+    }
+
+    /// Construction
+
+    /// The value of { L | R } is the simplest number between the greatest element of L and the least element of R.
+    /// The sets are ordered by value, so those are the last element of L and the first element of R.
+    Dyadic Dyadic::FromSurreal(Surreal const &number) {
+        Dyadic lo, hi;
+        if (!number.left.empty()) { lo = FromSurreal(*number.left.rbegin()); }
+        if (!number.right.empty()) { hi = FromSurreal(*number.right.begin()); }
+        return Simplest(number.left.empty() ? nullptr : &lo, number.right.empty() ? nullptr : &hi);
+    }
+
+    /// A double is m * 2^e with 53 bits of mantissa m, so m * 2^53 is an integer numerator over 2^(53 - e)
+    Dyadic Dyadic::FromDouble(double value) {
+        if (!std::isfinite(value)) { Overflow(); }
+        int e;
+        double mantissa = std::frexp(value, &e);
+        return Dyadic((std::int64_t) std::ldexp(mantissa, 53), 53 - e);
+    }
+
+    /// The simplest number in an interval is the integer of least magnitude in it, if there is one.
+    /// Otherwise the interval lies within (n, n + 1) for some integer n, and the simplest number is found by
+    /// halving that unit interval towards the bounds, which takes one step per bit of the result.
+    ///
+    /// \param lo: the lower bound (exclusive), or nullptr for none
+    /// \param hi: the upper bound (exclusive), or nullptr for none
+    /// \return the simplest number strictly between the bounds
+    Dyadic Dyadic::Simplest(Dyadic const *lo, Dyadic const *hi) {
+        if (lo != nullptr && hi != nullptr && !(*lo < *hi)) {
+            throw std::runtime_error("Bad bounds during dyadic simplification!");
+        }
+
+        if (lo == nullptr && hi == nullptr) { return Dyadic(); }
+        if (lo == nullptr) {
+            if (*hi > 0) { return Dyadic(); }
+            return Dyadic(hi->IsInteger() ? hi->num - 1 : hi->Floor());
+        }
+        if (hi == nullptr) {
+            if (*lo < 0) { return Dyadic(); }
+            return Dyadic(Add(lo->Floor(), 1));
+        }
+
+        if (*lo < 0 && *hi > 0) { return Dyadic(); }
+        if (*hi <= 0) {
+            /// mirror the interval to the positive side
+            Dyadic negHi = -*hi, negLo = -*lo;
+            return -Simplest(&negHi, &negLo);
+        }
+
+        Dyadic below(lo->Floor()), above(Add(lo->Floor(), 1));
+        if (above < *hi) { return above; }
+        while (true) {
+            Dyadic mid = (below + above).Half();
+            if (mid <= *lo) { below = mid; }
+            else if (mid >= *hi) { above = mid; }
+            else { return mid; }
+        }
+    }
+
+    /// The sign expansion is walked from 0. Each step replaces one of the bounds with the current number,
+    /// so the result is built on the numbers it is born between, like on the day it is born.
+    Surreal Dyadic::ToSurreal() const {
+        std::vector<bool> signs = SignExpansion();
+        Surreal current, lo, hi;
+        bool hasLo = false, hasHi = false;
+        for (bool up : signs) {
+            if (up) {
+                lo = current;
+                hasLo = true;
+            } else {
+                hi = current;
+                hasHi = true;
+            }
+            current = Surreal(hasLo ? std::set<Surreal>({lo}) : std::set<Surreal>(),
+                              hasHi ? std::set<Surreal>({hi}) : std::set<Surreal>(), false);
+        }
+        return current;
+    }
+
+    /// Properties
+
+    /// An integer n is born on day |n|. Any other number is born on day |floor(x)| + 1 + (number of fraction bits),
+    /// with floor taken on the magnitude.
+    std::int64_t Dyadic::Birthday() const {
+        std::int64_t magnitudeFloor = (num < 0) ? (-*this).Floor() : Floor();
+        if (IsInteger()) { return magnitudeFloor; }
+        return magnitudeFloor + 1 + exp;
+    }
+
+    /// For x > 0: floor(x) steps up for an integer x. Otherwise floor(x) + 1 steps up, one step down, and
+    /// then one step per bit of the fraction but the last, up for a 1 and down for a 0. Negative numbers mirror that.
+    std::vector<bool> Dyadic::SignExpansion() const {
+        std::vector<bool> signs;
+        if (num == 0) { return signs; }
+
+        bool positive = num > 0;
+        Dyadic magnitude = positive ? *this : -*this;
+        std::int64_t whole = magnitude.Floor();
+
+        if (magnitude.IsInteger()) {
+            signs.assign((std::size_t) whole, positive);
+            return signs;
+        }
+
+        signs.assign((std::size_t) whole + 1, positive);
+        signs.push_back(!positive);
+        std::int64_t fraction = magnitude.num - Shift(whole, magnitude.exp);
+        for (int bit = magnitude.exp - 1; bit > 0; bit--) {
+            bool one = ((fraction >> bit) & 1) != 0;
+            signs.push_back(one == positive);
+        }
+        return signs;
+    }
+
+    Dyadic Dyadic::FromSignExpansion(std::vector<bool> const &signs) {
+        Dyadic current, lo, hi;
+        bool hasLo = false, hasHi = false;
+        for (bool up : signs) {
+            if (up) {
+                lo = current;
+                hasLo = true;
+            } else {
+                hi = current;
+                hasHi = true;
+            }
+            current = Simplest(hasLo ? &lo : nullptr, hasHi ? &hi : nullptr);
+        }
+        return current;
+    }
+
+    bool Dyadic::IsInteger() const {
+        return exp == 0;
+    }
+
+    double Dyadic::Double() const {
+        return std::ldexp((double) num, -exp);
+    }
+
+    std::string Dyadic::ToString() const {
+        if (exp == 0) { return std::to_string(num); }
+        return std::to_string(num) + "/" + std::to_string((std::int64_t) 1 << exp);
+    }
+
+    std::size_t Dyadic::Hash() const {
+        std::uint64_t hash = (std::uint64_t) num * 0x9E3779B97F4A7C15ull + (std::uint64_t) exp;
+        hash ^= hash >> 31;
+        hash *= 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 29;
+        return (std::size_t) hash;
+    }
+
+    std::int64_t Dyadic::Floor() const {
+        if (exp == 0) { return num; }
+        if (num >= 0) { return num >> exp; }
+        return -((-num + ((std::int64_t) 1 << exp) - 1) >> exp);
+    }
+
+    /// Comparison
+
+    bool Dyadic::operator==(Dyadic const &other) const {
+        return num == other.num && exp == other.exp;
+    }
+
+    bool Dyadic::operator!=(Dyadic const &other) const {
+        return !(*this == other);
+    }
+
+    /// Compares the integer parts first, then the fractional parts, which never overflows
+    bool Dyadic::operator<(Dyadic const &other) const {
+        std::int64_t floorA = Floor(), floorB = other.Floor();
+        if (floorA != floorB) { return floorA < floorB; }
+
+        std::int64_t fracA = num - floorA * ((std::int64_t) 1 << exp);
+        std::int64_t fracB = other.num - floorB * ((std::int64_t) 1 << other.exp);
+        int common = std::max(exp, other.exp);
+        return fracA * ((std::int64_t) 1 << (common - exp)) < fracB * ((std::int64_t) 1 << (common - other.exp));
+    }
+
+    bool Dyadic::operator<=(Dyadic const &other) const {
+        return !(other < *this);
+    }
+
+    bool Dyadic::operator>(Dyadic const &other) const {
+        return other < *this;
+    }
+
+    bool Dyadic::operator>=(Dyadic const &other) const {
+        return !(*this < other);
+    }
+
+    /// Arithmetic
+
+    Dyadic Dyadic::operator-() const {
+        if (num == std::numeric_limits<std::int64_t>::min()) { Overflow(); }
+        Dyadic res;
+        res.num = -num;
+        res.exp = exp;
+        return res;
+    }
+
+    Dyadic Dyadic::operator+(Dyadic const &other) const {
+        int common = std::max(exp, other.exp);
+        return Dyadic(Add(Shift(num, common - exp), Shift(other.num, common - other.exp)), common);
+    }
+
+    Dyadic Dyadic::operator-(Dyadic const &other) const {
+        return *this + (-other);
+    }
+
+    Dyadic Dyadic::operator*(Dyadic const &other) const {
+        return Dyadic(Multiply(num, other.num), exp + other.exp);
+    }
+
+    Dyadic Dyadic::Half() const {
+        return Dyadic(num, exp + 1);
+    }
+
+    std::ostream &operator<<(std::ostream &os, Dyadic const &number) {
+        os << number.ToString();
+        return os;
+    }
+
+}
@@ -0,0 +1,112 @@
+///
+/// Exact dyadic rationals.
+///
+/// Every Surreal with finite sets has the value of a dyadic rational num / 2^exp. Dyadic holds that value
+/// exactly, in two machine words, so numbers can be compared, hashed and combined without walking their trees.
+/// Values are kept normalized (exp is 0 or num is odd), so equal values have equal fields.
+///
+/// The numerator is a signed 64-bit integer; operations whose exact result does not fit throw std::overflow_error.
+/// That covers every number born by day 62.
+///
+
+#ifndef SURREALS_DYADIC_H
+#define SURREALS_DYADIC_H
+
+#include "surreals.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace surreals {
+
+    /// An exact dyadic rational
+    class Dyadic {
+    public:
+        /// The value is num / 2^exp
+        std::int64_t num = 0;
+        int exp = 0;
+
+        /// Constructors
+        Dyadic() = default;
+
+        Dyadic(std::int64_t integer);
+
+        Dyadic(std::int64_t numerator, int exponent);
+
+        /// The value of a Surreal
+        static Dyadic FromSurreal(Surreal const &number);
+
+        /// The value of a double, which is always a dyadic rational. Throws std::overflow_error if it is
+        /// not finite, or its numerator or denominator does not fit.
+        static Dyadic FromDouble(double value);
+
+        /// The simplest (earliest born) number strictly between lo and hi.
+        /// A nullptr stands for an empty side, so Simplest(nullptr, nullptr) is 0.
+        static Dyadic Simplest(Dyadic const *lo, Dyadic const *hi);
+
+        /// The canonical Surreal of this value: { l | r }, where l and r are the closest numbers
+        /// born before it on either side (either may be missing)
+        Surreal ToSurreal() const;
+
+        /// The day this number is born on
+        std::int64_t Birthday() const;
+
+        /// The sign expansion: the path from 0 to this number, true for a step up and false for a step down
+        std::vector<bool> SignExpansion() const;
+
+        /// The number at the end of a sign expansion
+        static Dyadic FromSignExpansion(std::vector<bool> const &signs);
+
+        bool IsInteger() const;
+
+        double Double() const;
+
+        std::string ToString() const;
+
+        std::size_t Hash() const;
+
+        /// Comparison
+        bool operator==(Dyadic const &other) const;
+
+        bool operator!=(Dyadic const &other) const;
+
+        bool operator<(Dyadic const &other) const;
+
+        bool operator<=(Dyadic const &other) const;
+
+        bool operator>(Dyadic const &other) const;
+
+        bool operator>=(Dyadic const &other) const;
+
+        /// Arithmetic
+        Dyadic operator-() const;
+
+        Dyadic operator+(Dyadic const &other) const;
+
+        Dyadic operator-(Dyadic const &other) const;
+
+        Dyadic operator*(Dyadic const &other) const;
+
+        /// Half of this number
+        Dyadic Half() const;
+
+        /// The greatest integer not greater than this number
+        std::int64_t Floor() const;
+
+        friend std::ostream &operator<<(std::ostream &os, Dyadic const &number);
+
+    private:
+        void Normalize();
+    };
+
+    /// Hash functor, for unordered containers keyed by value
+    struct DyadicHash {
+        std::size_t operator()(Dyadic const &number) const {
+            return number.Hash();
+        }
+    };
+
+}
+
+#endif //SURREALS_DYADIC_H
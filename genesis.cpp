@@ -0,0 +1,297 @@
+///
+/// Implementations for the generation of the numbers born by each day.
+///
+
+#include "genesis.h"
+#include "parallel.h"
+
+#include <iterator>
+#include <mutex>
+
+namespace surreals {
+
+    Genesis::Genesis() : known({Dyadic()}) {}
+
+    int Genesis::Day() const {
+        return day;
+    }
+
+    /// The new numbers go to the even positions of the next sequence, and the known ones to the odd positions
+    /// between them, so the result comes out sorted without any comparisons.
+    void Genesis::NextDay() {
+        std::vector<Dyadic> next;
+        next.reserve(2 * known.size() + 1);
+
+        next.push_back(known.front() - 1);
+        for (std::size_t i = 0; i + 1 < known.size(); i++) {
+            next.push_back(known[i]);
+            next.push_back((known[i] + known[i + 1]).Half());
+        }
+        next.push_back(known.back());
+        next.push_back(known.back() + 1);
+
+        known.swap(next);
+        day++;
+    }
+
+    void Genesis::AdvanceTo(int target) {
+        while (day < target) { NextDay(); }
+    }
+
+    std::vector<Dyadic> const &Genesis::Known() const {
+        return known;
+    }
+
+    /// The numbers born on Day() are at the even positions of the sequence. Dropping them leaves the sequence
+    /// of the day before, so the numbers born on an earlier day are found by halving the stride.
+    ///
+    /// \param target: the day, in [0, Day()]
+    /// \return the numbers born on that day
+    std::vector<Dyadic> Genesis::BornOn(int target) const {
+        if (target < 0 || target > day) { throw std::runtime_error("Requested a day that was not generated!"); }
+
+        std::size_t stride = (std::size_t) 1 << (day - target);
+        std::vector<Dyadic> res;
+        res.reserve(known.size() / (2 * stride) + 1);
+        for (std::size_t i = stride - 1; i < known.size(); i += 2 * stride) { res.push_back(known[i]); }
+        return res;
+    }
+
+    std::size_t Genesis::Size() const {
+        return known.size();
+    }
+
+    Surreal Genesis::Materialize(std::size_t index) const {
+        return known.at(index).ToSurreal();
+    }
+
+    /// Streaming
+
+    /// The bits of k, highest first, are the signs: a run of equal signs steps by whole units, and after the
+    /// first change of direction every step is half the one before. Both are added up over the denominator 2^h,
+    /// where h is the amount of halving steps.
+    ///
+    /// \param day: the day, in [0, 62]
+    /// \param k: the position among the numbers born on that day, in [0, 2^day)
+    /// \return the number
+    Dyadic GenesisRange::Nth(int day, std::uint64_t k) {
+        if (day < 0 || day > 62) { throw std::overflow_error("Genesis day out of range!"); }
+        if (day == 0) { return Dyadic(); }
+
+        int bit = day - 1;
+        bool up = ((k >> bit) & 1) != 0;
+        std::int64_t run = 0;
+        while (bit >= 0 && (((k >> bit) & 1) != 0) == up) {
+            run++;
+            bit--;
+        }
+
+        int halvings = bit + 1;
+        std::int64_t numerator = (up ? run : -run) * ((std::int64_t) 1 << halvings);
+        for (; bit >= 0; bit--) {
+            std::int64_t step = (std::int64_t) 1 << bit;
+            numerator += (((k >> bit) & 1) != 0) ? step : -step;
+        }
+        return Dyadic(numerator, halvings);
+    }
+
+    GenesisRange::GenesisRange(int firstDay, int lastDay) : firstDay(firstDay), lastDay(lastDay) {
+        if (firstDay < 0 || lastDay > 62) { throw std::overflow_error("Genesis day out of range!"); }
+    }
+
+    GenesisRange GenesisRange::BornOn(int day) {
+        return GenesisRange(day, day);
+    }
+
+    /// Day n has 2^n numbers, so days a through b have 2^(b+1) - 2^a
+    std::uint64_t GenesisRange::Size() const {
+        if (firstDay > lastDay) { return 0; }
+        return ((std::uint64_t) 1 << (lastDay + 1)) - ((std::uint64_t) 1 << firstDay);
+    }
+
+    GenesisRange::Iterator GenesisRange::begin() const {
+        if (firstDay > lastDay) { return end(); }
+        return Iterator(firstDay, 0);
+    }
+
+    /// The end is the first number of the day after the range, which is never dereferenced
+    GenesisRange::Iterator GenesisRange::end() const {
+        Iterator res;
+        res.day = std::max(firstDay, lastDay + 1);
+        return res;
+    }
+
+    GenesisRange::Iterator::Iterator(int day, std::uint64_t index) : day(day), index(index), value(Nth(day, index)) {}
+
+    Dyadic const &GenesisRange::Iterator::operator*() const {
+        return value;
+    }
+
+    Dyadic const *GenesisRange::Iterator::operator->() const {
+        return &value;
+    }
+
+    GenesisRange::Iterator &GenesisRange::Iterator::operator++() {
+        index++;
+        if (index == ((std::uint64_t) 1 << day)) {
+            day++;
+            index = 0;
+        }
+        if (day <= 62) { value = Nth(day, index); }
+        return *this;
+    }
+
+    GenesisRange::Iterator GenesisRange::Iterator::operator++(int) {
+        Iterator res = *this;
+        ++*this;
+        return res;
+    }
+
+    bool GenesisRange::Iterator::operator==(Iterator const &other) const {
+        return day == other.day && index == other.index;
+    }
+
+    bool GenesisRange::Iterator::operator!=(Iterator const &other) const {
+        return !(*this == other);
+    }
+
+    int GenesisRange::Iterator::Day() const {
+        return day;
+    }
+
+    std::uint64_t GenesisRange::Iterator::Index() const {
+        return index;
+    }
+
+    /// Closure
+
+    ClosureGenesis::ClosureGenesis() : known({Dyadic()}), frontier({Dyadic()}), seen({Dyadic()}) {}
+
+    int ClosureGenesis::Day() const {
+        return day;
+    }
+
+    /// A set of Dyadics that several threads can add to at once.
+    /// Values are spread over shards by hash, and each shard has its own lock, so threads rarely wait on each other.
+    class ShardedSet {
+    public:
+        explicit ShardedSet(std::size_t shardCount) : shards(shardCount) {}
+
+        /// Add a batch of values, taking the lock of each shard once
+        void Insert(std::unordered_set<Dyadic, DyadicHash> const &values) {
+            std::vector<std::vector<Dyadic>> byShard(shards.size());
+            for (Dyadic const &value : values) { byShard[ShardOf(value)].push_back(value); }
+            for (std::size_t i = 0; i < shards.size(); i++) {
+                if (byShard[i].empty()) { continue; }
+                std::lock_guard<std::mutex> lock(shards[i].mutex);
+                shards[i].values.insert(byShard[i].begin(), byShard[i].end());
+            }
+        }
+
+        /// Every value added, in no particular order. Not to be called while values are being added.
+        std::vector<Dyadic> Values() const {
+            std::vector<Dyadic> res;
+            for (Shard const &shard : shards) { res.insert(res.end(), shard.values.begin(), shard.values.end()); }
+            return res;
+        }
+
+    private:
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_set<Dyadic, DyadicHash> values;
+        };
+
+        /// The high bits of the hash pick the shard, the low bits are left to the buckets within it
+        std::size_t ShardOf(Dyadic const &value) const {
+            return (std::size_t) ((std::uint64_t) value.Hash() >> 40) % shards.size();
+        }
+
+        std::vector<Shard> shards;
+    };
+
+    void ClosureGenesis::NextDay() {
+        NextDay(1);
+    }
+
+    /// Every number of the frontier is combined with every known number. Known and frontier are both sorted,
+    /// so walking them side by side tells which known numbers are in the frontier; a pair of two frontier
+    /// numbers is only tried once, from its greater member.
+    ///
+    /// The known numbers (and the set of them) are only read during the round, so blocks of the frontier
+    /// can be combined on any thread. An exception (std::overflow_error) leaves them untouched.
+    void ClosureGenesis::NextDay(unsigned threads) {
+        /// a few blocks per thread balance the load; more would mostly repeat the deduplication across blocks
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+        std::size_t blocks = std::min<std::size_t>(frontier.size(), (threads == 1) ? 1 : 8 * (std::size_t) threads);
+        std::size_t blockSize = (frontier.size() + blocks - 1) / blocks;
+        ShardedSet found(64);
+
+        ParallelFor(blocks, threads, [this, &found, blockSize](std::size_t block) {
+            std::unordered_set<Dyadic, DyadicHash> local;
+            auto add = [&local](Dyadic const &value) {
+                local.insert(value);
+            };
+
+            std::size_t end = std::min(frontier.size(), (block + 1) * blockSize);
+            for (std::size_t i = block * blockSize; i < end; i++) {
+                Dyadic const &a = frontier[i];
+                add(Dyadic::Simplest(&a, nullptr));
+                add(Dyadic::Simplest(nullptr, &a));
+                add(-a);
+
+                auto nextNew = frontier.begin();
+                for (Dyadic const &b : known) {
+                    while (nextNew != frontier.end() && *nextNew < b) { nextNew++; }
+                    bool bIsNew = (nextNew != frontier.end() && *nextNew == b);
+                    if (b == a || (bIsNew && b < a)) { continue; }
+
+                    Dyadic const &lo = (a < b) ? a : b, &hi = (a < b) ? b : a;
+                    add(Dyadic::Simplest(&lo, &hi));
+                    add(a + b);
+                    add(a * b);
+                }
+            }
+
+            found.Insert(local);
+        });
+
+        std::vector<Dyadic> fresh = found.Values();
+        fresh.erase(std::remove_if(fresh.begin(), fresh.end(), [this](Dyadic const &value) {
+            return seen.count(value) != 0;
+        }), fresh.end());
+        std::sort(fresh.begin(), fresh.end());
+        seen.insert(fresh.begin(), fresh.end());
+
+        std::vector<Dyadic> merged;
+        merged.reserve(known.size() + fresh.size());
+        std::merge(known.begin(), known.end(), fresh.begin(), fresh.end(), std::back_inserter(merged));
+        known.swap(merged);
+        frontier.swap(fresh);
+        day++;
+    }
+
+    void ClosureGenesis::AdvanceTo(int target) {
+        AdvanceTo(target, 1);
+    }
+
+    void ClosureGenesis::AdvanceTo(int target, unsigned threads) {
+        while (day < target) { NextDay(threads); }
+    }
+
+    std::vector<Dyadic> const &ClosureGenesis::Known() const {
+        return known;
+    }
+
+    std::vector<Dyadic> const &ClosureGenesis::Frontier() const {
+        return frontier;
+    }
+
+    std::size_t ClosureGenesis::Size() const {
+        return known.size();
+    }
+
+    Surreal ClosureGenesis::Materialize(std::size_t index) const {
+        return known.at(index).ToSurreal();
+    }
+
+}
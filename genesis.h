@@ -0,0 +1,182 @@
+///
+/// Generation of the numbers born by each day.
+///
+/// On day 0 the only number is { | } = 0. On every later day, one new number is born in each gap of the
+/// numbers known so far: the midpoint of every two neighbours, one less than the least number, and one more
+/// than the greatest. Trying { A | B } for every pair of known numbers yields nothing else, since a pair that
+/// is not neighbouring has an older number between it.
+///
+/// Genesis keeps the numbers born so far as a sorted sequence of exact dyadic values, and produces the next day
+/// by a single pass over it that interleaves the new numbers with the known ones. Day n holds 2^(n+1) - 1 numbers,
+/// so each day takes time and memory linear in its size, and day 20 (about two million numbers) takes a fraction
+/// of a second. Surreals are only built on request, in the form { l | r } of the neighbours they are born between.
+///
+
+#ifndef SURREALS_GENESIS_H
+#define SURREALS_GENESIS_H
+
+#include "dyadic.h"
+
+#include <cstdint>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+namespace surreals {
+
+    /// The numbers born by some day, in increasing order
+    class Genesis {
+    public:
+        /// Start at day 0
+        Genesis();
+
+        /// The last day generated
+        int Day() const;
+
+        /// Generate the numbers born on the next day
+        void NextDay();
+
+        /// Generate every day up to (and including) the given one
+        void AdvanceTo(int day);
+
+        /// The numbers born by Day(), in increasing order
+        std::vector<Dyadic> const &Known() const;
+
+        /// The numbers born on a day no later than Day(), in increasing order
+        std::vector<Dyadic> BornOn(int day) const;
+
+        /// The amount of numbers born by Day()
+        std::size_t Size() const;
+
+        /// The Surreal of Known()[index]
+        Surreal Materialize(std::size_t index) const;
+
+    private:
+        int day = 0;
+        std::vector<Dyadic> known;
+    };
+
+    /// Streams the numbers born on a range of days: day by day, each day in increasing order.
+    ///
+    /// The numbers born on day n are the ends of the sign expansions of length n. Read as n bits, highest first,
+    /// with 1 for a step up, those expansions count from 0 to 2^n - 1 in the order of the numbers, so the k-th
+    /// number of a day is computed from k alone. The iterator only holds the day, k and the current number,
+    /// so any day can be scanned (or sampled, or abandoned) without the days before it.
+    ///
+    /// Values stay exact up to day 62, the last day whose numbers fit a Dyadic.
+    class GenesisRange {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Dyadic;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Dyadic const *;
+            using reference = Dyadic const &;
+
+            Iterator() = default;
+
+            Dyadic const &operator*() const;
+
+            Dyadic const *operator->() const;
+
+            Iterator &operator++();
+
+            Iterator operator++(int);
+
+            bool operator==(Iterator const &other) const;
+
+            bool operator!=(Iterator const &other) const;
+
+            /// The day the current number is born on
+            int Day() const;
+
+            /// The position of the current number among the numbers born on its day
+            std::uint64_t Index() const;
+
+        private:
+            friend class GenesisRange;
+
+            Iterator(int day, std::uint64_t index);
+
+            int day = 0;
+            std::uint64_t index = 0;
+            Dyadic value;
+        };
+
+        /// The numbers born on days firstDay through lastDay (both included, in [0, 62])
+        GenesisRange(int firstDay, int lastDay);
+
+        /// The numbers born on a single day
+        static GenesisRange BornOn(int day);
+
+        /// The k-th number born on a day, in increasing order
+        static Dyadic Nth(int day, std::uint64_t k);
+
+        /// The amount of numbers in the range
+        std::uint64_t Size() const;
+
+        Iterator begin() const;
+
+        Iterator end() const;
+
+    private:
+        int firstDay, lastDay;
+    };
+
+    /// The numbers reached from 0 by rounds of { A | }, { | A }, -A, and for pairs A < B, { A | B }, A + B and A * B.
+    ///
+    /// Each round only tries the constructions involving at least one number that is new since the round before
+    /// (the frontier): every other combination was already tried in an earlier round, and its result is known.
+    /// A round therefore costs time proportional to the size of the frontier times the amount of known numbers,
+    /// plus sorting the new results into the known ones.
+    ///
+    /// With several threads, the frontier is split into blocks that are combined independently. New results are
+    /// deduplicated per block and then through a hash set split into shards with a lock each, and sorted once
+    /// all blocks are done, so the known numbers are only written between rounds.
+    ///
+    /// The amount of numbers grows about quadratically with every round (there are 58197 after six rounds),
+    /// and magnitudes square, so values soon leave the range of Dyadic. NextDay then throws std::overflow_error
+    /// and leaves the known numbers as they were.
+    class ClosureGenesis {
+    public:
+        /// Start at round 0, with the single number 0
+        ClosureGenesis();
+
+        /// The amount of rounds done
+        int Day() const;
+
+        /// Do the next round
+        void NextDay();
+
+        /// Do the next round on a pool of threads (0 picks the amount of hardware threads).
+        /// The result is the same as with one thread.
+        void NextDay(unsigned threads);
+
+        /// Do every round up to (and including) the given one
+        void AdvanceTo(int day);
+
+        void AdvanceTo(int day, unsigned threads);
+
+        /// The numbers known after Day() rounds, in increasing order
+        std::vector<Dyadic> const &Known() const;
+
+        /// The numbers that were new in the last round, in increasing order
+        std::vector<Dyadic> const &Frontier() const;
+
+        /// The amount of known numbers
+        std::size_t Size() const;
+
+        /// The Surreal of Known()[index]
+        Surreal Materialize(std::size_t index) const;
+
+    private:
+        int day = 0;
+        std::vector<Dyadic> known;
+        std::vector<Dyadic> frontier;
+        std::unordered_set<Dyadic, DyadicHash> seen; /// the same numbers as known, for membership checks
+    };
+
+}
+
+#endif //SURREALS_GENESIS_H
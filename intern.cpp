@@ -0,0 +1,58 @@
+///
+/// Implementations for the structural interning of Surreals.
+///
+
+#include "intern.h"
+
+namespace surreals {
+
+    /// Each frame collects the numbers of the terms of its node, and the node is numbered once it is complete.
+    std::size_t SurrealInterner::Intern(Surreal const &number, Visit const &visit) {
+        struct Frame {
+            Surreal const *node;
+            bool onRight;
+            std::set<Surreal>::const_iterator next;
+            Children children;
+        };
+
+        std::vector<Frame> stack;
+        stack.push_back(Frame{&number, false, number.left.begin(), Children()});
+        std::size_t root = 0;
+
+        while (!stack.empty()) {
+            Frame &top = stack.back();
+            std::set<Surreal> const &side = top.onRight ? top.node->right : top.node->left;
+
+            if (top.next != side.end()) {
+                Surreal const &term = *top.next++;
+                stack.push_back(Frame{&term, false, term.left.begin(), Children()});
+                continue;
+            }
+            if (!top.onRight) {
+                top.onRight = true;
+                top.next = top.node->right.begin();
+                continue;
+            }
+
+            /// the node is complete: number it, unless its structure is known already
+            auto found = ids.find(top.children);
+            bool isNew = (found == ids.end());
+            if (isNew) { found = ids.emplace(std::move(top.children), ids.size()).first; }
+            std::size_t id = found->second;
+            if (visit) { visit(id, found->first, isNew, stack.size() - 1); }
+
+            stack.pop_back();
+            if (stack.empty()) { root = id; }
+            else {
+                Frame &parent = stack.back();
+                (parent.onRight ? parent.children.second : parent.children.first).push_back(id);
+            }
+        }
+        return root;
+    }
+
+    std::size_t SurrealInterner::Size() const {
+        return ids.size();
+    }
+
+}
@@ -0,0 +1,50 @@
+///
+/// Structural interning of Surreals.
+///
+/// Surreals hold their sets by value, so equal subtrees are stored (and walked) once per occurrence. An interner
+/// numbers the distinct structures instead: a node is identified by the numbers of its left and right children,
+/// so two subtrees get the same number exactly when they have the same structure. The numbers are kept from one
+/// call to the next, so structure shared between several numbers is found as well.
+///
+/// The walk keeps one frame per level instead of recursing, so deep numbers do not exhaust the stack.
+/// It still visits every occurrence of every subtree.
+///
+
+#ifndef SURREALS_INTERN_H
+#define SURREALS_INTERN_H
+
+#include "surreals.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace surreals {
+
+    class SurrealInterner {
+    public:
+        /// The numbers of the left and the right children of a node, in the order of the sets
+        using Children = std::pair<std::vector<std::size_t>, std::vector<std::size_t>>;
+
+        /// Called for every node occurrence as it is completed, children first, with the number of the node,
+        /// its children, whether its structure was seen here for the first time, and its depth in the walked
+        /// tree (0 for the root). Numbers are given out in the order the structures are first seen.
+        using Visit = std::function<void(std::size_t id, Children const &children, bool isNew, std::size_t depth)>;
+
+        /// Number the nodes of a tree
+        ///
+        /// \param number: the tree to walk
+        /// \param visit: called for every node, may be empty
+        /// \return the number of the root
+        std::size_t Intern(Surreal const &number, Visit const &visit = Visit());
+
+        /// How many distinct structures have been seen
+        std::size_t Size() const;
+
+    private:
+        std::map<Children, std::size_t> ids;
+    };
+
+}
+
+#endif //SURREALS_INTERN_H
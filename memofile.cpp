@@ -0,0 +1,304 @@
+///
+/// Implementations for the memory-mapped lookup table file.
+///
+
+#include "memofile.h"
+#include "intern.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SURREALS_HAVE_MMAP 1
+#endif
+
+namespace surreals {
+
+    static const char Magic[4] = {'S', 'R', 'M', 'M'};
+    static const std::uint32_t ByteOrderMark = 0x01020304;
+
+    struct FileHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t nodeCount;
+        std::uint32_t childCount;
+        std::uint32_t sumCount;
+        std::uint32_t productCount;
+        std::uint32_t reserved;
+    };
+
+    /// Dump
+
+    /// Node table under construction. Nodes are numbered by their structure, so every distinct subtree of every
+    /// key and value is stored once, after its children.
+    struct NodeTable {
+        SurrealInterner interner;
+        std::vector<std::uint32_t> nodes; /// firstChild, leftCount, rightCount for each node
+        std::vector<std::uint32_t> children;
+
+        std::uint32_t Intern(Surreal const &number) {
+            return (std::uint32_t) interner.Intern(number, [this](std::size_t, SurrealInterner::Children const &key,
+                                                                  bool isNew, std::size_t) {
+                if (!isNew) { return; }
+                nodes.push_back((std::uint32_t) children.size());
+                nodes.push_back((std::uint32_t) key.first.size());
+                nodes.push_back((std::uint32_t) key.second.size());
+                for (std::size_t child : key.first) { children.push_back((std::uint32_t) child); }
+                for (std::size_t child : key.second) { children.push_back((std::uint32_t) child); }
+            });
+        }
+
+        /// Intern the keys and values of a table, in table order
+        std::vector<std::uint32_t> Entries(std::map<std::pair<Surreal, Surreal>, Surreal> const &table) {
+            std::vector<std::uint32_t> res;
+            for (auto const &entry : table) {
+                res.push_back(Intern(entry.first.first));
+                res.push_back(Intern(entry.first.second));
+                res.push_back(Intern(entry.second));
+            }
+            return res;
+        }
+    };
+
+    /// Write the lookup tables into a file.
+    /// Entries of an installed base layer that are missing from the in-memory tables are written as well,
+    /// so a dump taken after a warm start holds everything known so far.
+    ///
+    /// \param path: the file to write
+    void MemoFile::Dump(std::string const &path) {
+        std::map<std::pair<Surreal, Surreal>, Surreal> sumTable = Surreal::AddLookup;
+        std::map<std::pair<Surreal, Surreal>, Surreal> productTable = Surreal::MultLookup;
+        if (Surreal::LookupBase) {
+            Surreal::LookupBase->CopyEntries(Surreal::LookupBase->sums, Surreal::LookupBase->sumCount, sumTable);
+            Surreal::LookupBase->CopyEntries(Surreal::LookupBase->products, Surreal::LookupBase->productCount,
+                                             productTable);
+        }
+
+        NodeTable table;
+        std::vector<std::uint32_t> sumEntries = table.Entries(sumTable);
+        std::vector<std::uint32_t> productEntries = table.Entries(productTable);
+
+        FileHeader header = {};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.byteOrder = ByteOrderMark;
+        header.nodeCount = (std::uint32_t) table.interner.Size();
+        header.childCount = (std::uint32_t) table.children.size();
+        header.sumCount = (std::uint32_t) sumTable.size();
+        header.productCount = (std::uint32_t) productTable.size();
+
+        /// The base layer may be mapped from this very path, so the file is never rewritten in place:
+        /// the tables go to a new file, which then replaces the old one, and the mapping keeps the old one.
+        std::string temp = path + ".tmp";
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        auto write = [&out](std::vector<std::uint32_t> const &v) {
+            out.write(reinterpret_cast<char const *>(v.data()), (std::streamsize) (v.size() * sizeof(std::uint32_t)));
+        };
+        out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        write(table.nodes);
+        write(table.children);
+        write(sumEntries);
+        write(productEntries);
+        out.close();
+        if (!out) {
+            std::remove(temp.c_str());
+            throw std::runtime_error("Failed to write the lookup table file " + path + "!");
+        }
+
+        if (std::rename(temp.c_str(), path.c_str()) != 0) {
+            std::remove(path.c_str()); /// where rename does not replace an existing file
+            if (std::rename(temp.c_str(), path.c_str()) != 0) {
+                std::remove(temp.c_str());
+                throw std::runtime_error("Failed to write the lookup table file " + path + "!");
+            }
+        }
+    }
+
+    /// Load
+
+    /// Map a file and install it as the base layer of the lookup tables, replacing any previous one
+    ///
+    /// \param path: the file to map
+    void MemoFile::Load(std::string const &path) {
+        Surreal::LookupBase = std::make_shared<MemoFile>(path);
+    }
+
+    /// Map the file read-only, or read it into a buffer where mmap is not available, then check the layout
+    MemoFile::MemoFile(std::string const &path) {
+#ifdef SURREALS_HAVE_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void *addr = mmap(nullptr, (std::size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    data = static_cast<char const *>(addr);
+                    size = (std::size_t) st.st_size;
+                    mapped = true;
+                }
+            }
+            close(fd);
+        }
+#endif
+        if (!mapped) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) { throw std::runtime_error("Failed to open the lookup table file " + path + "!"); }
+            buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            data = buffer.data();
+            size = buffer.size();
+        }
+
+        FileHeader header;
+        if (size < sizeof(header)) { throw std::runtime_error("Not a lookup table file: " + path + "!"); }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.byteOrder != ByteOrderMark) {
+            throw std::runtime_error("Not a lookup table file: " + path + "!");
+        }
+        if (header.version > Version) {
+            throw std::runtime_error("Unsupported lookup table file version: " + path + "!");
+        }
+
+        std::size_t expected = sizeof(header) + (std::size_t) header.nodeCount * sizeof(Node) +
+                               (std::size_t) header.childCount * sizeof(std::uint32_t) +
+                               ((std::size_t) header.sumCount + header.productCount) * sizeof(Entry);
+        if (size < expected) { throw std::runtime_error("Truncated lookup table file: " + path + "!"); }
+
+        nodeCount = header.nodeCount;
+        sumCount = header.sumCount;
+        productCount = header.productCount;
+        char const *cursor = data + sizeof(header);
+        nodes = reinterpret_cast<Node const *>(cursor);
+        cursor += nodeCount * sizeof(Node);
+        children = reinterpret_cast<std::uint32_t const *>(cursor);
+        cursor += (std::size_t) header.childCount * sizeof(std::uint32_t);
+        sums = reinterpret_cast<Entry const *>(cursor);
+        products = sums + sumCount;
+
+        /// every index must stay within the file, and the children of a node must come before it (Materialize
+        /// relies on that to terminate), so lookups never need to check
+        for (std::size_t i = 0; i < nodeCount; i++) {
+            std::size_t end = (std::size_t) nodes[i].firstChild + nodes[i].leftCount + nodes[i].rightCount;
+            if (end > header.childCount) { throw std::runtime_error("Corrupt lookup table file: " + path + "!"); }
+            for (std::size_t k = nodes[i].firstChild; k < end; k++) {
+                if (children[k] >= i) { throw std::runtime_error("Corrupt lookup table file: " + path + "!"); }
+            }
+        }
+        for (std::size_t i = 0; i < sumCount + productCount; i++) {
+            Entry const &entry = sums[i];
+            if (entry.a >= nodeCount || entry.b >= nodeCount || entry.result >= nodeCount) {
+                throw std::runtime_error("Corrupt lookup table file: " + path + "!");
+            }
+        }
+
+        built.resize(nodeCount);
+    }
+
+    MemoFile::~MemoFile() {
+#ifdef SURREALS_HAVE_MMAP
+        if (mapped) { munmap(const_cast<char *>(data), size); }
+#endif
+    }
+
+    /// Lookup
+
+    /// Nodes are built bottom-up through the checking constructor, since a child always comes before its parent
+    /// in the file. Built nodes are never released, so the returned reference stays valid.
+    ///
+    /// \param node: the node index
+    /// \return the number
+    Surreal const &MemoFile::Materialize(std::uint32_t node) const {
+        std::lock_guard<std::mutex> lock(builtMutex);
+        if (built[node]) { return *built[node]; }
+
+        /// build the missing nodes of the subtree, children first
+        std::vector<std::uint32_t> stack = {node};
+        while (!stack.empty()) {
+            std::uint32_t top = stack.back();
+            if (built[top]) {
+                stack.pop_back();
+                continue;
+            }
+
+            Node const &entry = nodes[top];
+            std::uint32_t const *first = children + entry.firstChild;
+            std::uint32_t const *last = first + entry.leftCount + entry.rightCount;
+            bool ready = true;
+            for (std::uint32_t const *child = first; child != last; child++) {
+                if (!built[*child]) {
+                    stack.push_back(*child);
+                    ready = false;
+                }
+            }
+            if (!ready) { continue; }
+
+            std::set<Surreal> left, right;
+            for (std::uint32_t i = 0; i < entry.leftCount; i++) { left.insert(*built[first[i]]); }
+            for (std::uint32_t i = entry.leftCount; i < entry.leftCount + entry.rightCount; i++) {
+                right.insert(*built[first[i]]);
+            }
+            built[top].reset(new Surreal(left, right, false));
+            stack.pop_back();
+        }
+        return *built[node];
+    }
+
+    /// The entries are sorted like the keys of std::map<std::pair<Surreal, Surreal>, Surreal>,
+    /// so the search uses the same (value-based) ordering of pairs.
+    bool MemoFile::Find(Entry const *entries, std::size_t count, Surreal const &a, Surreal const &b,
+                        Surreal &out) const {
+        std::pair<Surreal const &, Surreal const &> key = std::minmax(a, b);
+
+        std::size_t lo = 0, hi = count; /// the first entry not less than the key is in [lo, hi]
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            Surreal const &first = Materialize(entries[mid].a);
+            bool less = (first < key.first) || (!(key.first < first) && Materialize(entries[mid].b) < key.second);
+            if (less) { lo = mid + 1; }
+            else { hi = mid; }
+        }
+        if (lo == count) { return false; }
+
+        if (key.first < Materialize(entries[lo].a) || key.second < Materialize(entries[lo].b)) { return false; }
+        out = Materialize(entries[lo].result);
+        return true;
+    }
+
+    bool MemoFile::FindSum(Surreal const &a, Surreal const &b, Surreal &out) const {
+        return Find(sums, sumCount, a, b, out);
+    }
+
+    bool MemoFile::FindProduct(Surreal const &a, Surreal const &b, Surreal &out) const {
+        return Find(products, productCount, a, b, out);
+    }
+
+    void MemoFile::CopyEntries(Entry const *entries, std::size_t count,
+                               std::map<std::pair<Surreal, Surreal>, Surreal> &table) const {
+        for (std::size_t i = 0; i < count; i++) {
+            table.emplace(std::make_pair(Materialize(entries[i].a), Materialize(entries[i].b)),
+                          Materialize(entries[i].result));
+        }
+    }
+
+    std::size_t MemoFile::NodeCount() const {
+        return nodeCount;
+    }
+
+    std::size_t MemoFile::SumCount() const {
+        return sumCount;
+    }
+
+    std::size_t MemoFile::ProductCount() const {
+        return productCount;
+    }
+
+    bool MemoFile::Mapped() const {
+        return mapped;
+    }
+
+}
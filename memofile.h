@@ -0,0 +1,115 @@
+///
+/// Memory-mapped base layer for the arithmetic lookup tables.
+///
+/// Surreal::AddLookup and Surreal::MultLookup start out empty in every process. MemoFile::Dump writes them
+/// to a file, and MemoFile::Load maps such a file back as a read-only base layer (Surreal::LookupBase):
+/// addition and multiplication consult it after missing the in-memory tables, which remain the writable
+/// overlay. A result found in the base layer is copied into the overlay, so it is only looked up once.
+///
+/// The file is laid out so it can be used in place, without parsing:
+///     header:   magic "SRMM", version, byte order mark, node/child/entry counts (8 x uint32)
+///     nodes:    for each distinct number, the index of its first child, the sizes of its left and right sets
+///     children: node indices, the left children of a node followed by its right children
+///     sums:     (a, b, a + b) node index triples, sorted in the order of AddLookup
+///     products: (a, b, a * b) node index triples, sorted in the order of MultLookup
+/// All fields are uint32 in host byte order; a file written on a machine with another byte order is rejected.
+///
+/// Lookups binary search the sorted entries. Nodes are turned into Surreals only when a search touches them,
+/// and are kept once built, so a lookup costs O(log n) comparisons plus the nodes it had to build.
+///
+
+#ifndef SURREALS_MEMOFILE_H
+#define SURREALS_MEMOFILE_H
+
+#include "surreals.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace surreals {
+
+    /// A read-only lookup table file, mapped into memory
+    class MemoFile {
+    public:
+        /// The version of the file layout
+        static const std::uint32_t Version = 1;
+
+        /// Write AddLookup and MultLookup (together with the entries of the installed base layer, if any).
+        /// The file is replaced as a whole, so it may be the one the base layer is mapped from.
+        static void Dump(std::string const &path);
+
+        /// Map a file and install it as Surreal::LookupBase
+        static void Load(std::string const &path);
+
+        /// Map a file. Throws std::runtime_error if it can not be read or is not a valid table file.
+        explicit MemoFile(std::string const &path);
+
+        MemoFile(MemoFile const &) = delete;
+
+        MemoFile &operator=(MemoFile const &) = delete;
+
+        /// Destructor, unmaps the file
+        ~MemoFile();
+
+        /// Look up a + b. Returns false if the pair is not in the file.
+        bool FindSum(Surreal const &a, Surreal const &b, Surreal &out) const;
+
+        /// Look up a * b. Returns false if the pair is not in the file.
+        bool FindProduct(Surreal const &a, Surreal const &b, Surreal &out) const;
+
+        /// Sizes of the tables in the file
+        std::size_t NodeCount() const;
+
+        std::size_t SumCount() const;
+
+        std::size_t ProductCount() const;
+
+        /// Whether the file is memory-mapped, rather than read into a buffer
+        bool Mapped() const;
+
+    private:
+        struct Node {
+            std::uint32_t firstChild;
+            std::uint32_t leftCount;
+            std::uint32_t rightCount;
+        };
+
+        struct Entry {
+            std::uint32_t a;
+            std::uint32_t b;
+            std::uint32_t result;
+        };
+
+        /// Build (or fetch the already built) number of a node
+        Surreal const &Materialize(std::uint32_t node) const;
+
+        /// Binary search one of the entry tables
+        bool Find(Entry const *entries, std::size_t count, Surreal const &a, Surreal const &b, Surreal &out) const;
+
+        /// Copy every entry of one of the tables into a map
+        void CopyEntries(Entry const *entries, std::size_t count,
+                         std::map<std::pair<Surreal, Surreal>, Surreal> &table) const;
+
+        /// The file contents, either mapped or in the buffer
+        char const *data = nullptr;
+        std::size_t size = 0;
+        bool mapped = false;
+        std::vector<char> buffer;
+
+        Node const *nodes = nullptr;
+        std::uint32_t const *children = nullptr;
+        Entry const *sums = nullptr;
+        Entry const *products = nullptr;
+        std::size_t nodeCount = 0, sumCount = 0, productCount = 0;
+
+        /// Nodes built so far, by index
+        mutable std::vector<std::unique_ptr<Surreal>> built;
+        mutable std::mutex builtMutex;
+    };
+
+}
+
+#endif //SURREALS_MEMOFILE_H
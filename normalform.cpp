@@ -0,0 +1,303 @@
+///
+/// Implementations for functions of the NormalForm class.
+///
+
+#include "normalform.h"
+#include "dyadic.h"
+
+#include <sstream>
+
+namespace surreals {
+
+    /// Shared exponents for the most common terms
+    static std::shared_ptr<const NormalForm> const &ZeroExponent() {
+        static std::shared_ptr<const NormalForm> const zero = std::make_shared<const NormalForm>();
+        return zero;
+    }
+
+    /// Constructors
+
+    /// Zero, which has no terms
+    NormalForm::NormalForm() = default;
+
+    /// Constructor from a real number
+    ///
+    /// \param real: the real number, stored as the coefficient of w^0
+    NormalForm::NormalForm(double real) {
+        if (real != 0.0) { terms.push_back(Term{ZeroExponent(), real}); }
+    }
+
+    /// Constructor from a single term
+    ///
+    /// \param coefficient: the real coefficient
+    /// \param exponent: the power of Omega
+    NormalForm::NormalForm(double coefficient, NormalForm const &exponent) {
+        if (coefficient != 0.0) {
+            terms.push_back(Term{std::make_shared<const NormalForm>(exponent), coefficient});
+        }
+    }
+
+    /// Omega = w^1
+    NormalForm NormalForm::Omega() { return NormalForm(1.0, NormalForm(1.0)); }
+
+    /// Epsilon = w^-1 = 1 / Omega
+    NormalForm NormalForm::Epsilon() { return NormalForm(1.0, NormalForm(-1.0)); }
+
+    /// Properties
+
+    bool NormalForm::IsZero() const { return terms.empty(); }
+
+    bool NormalForm::IsReal() const {
+        return terms.empty() || (terms.size() == 1 && terms[0].exponent->IsZero());
+    }
+
+    bool NormalForm::IsInfinite() const {
+        return !terms.empty() && terms[0].exponent->Sign() > 0;
+    }
+
+    bool NormalForm::IsInfinitesimal() const {
+        return !terms.empty() && terms[0].exponent->Sign() < 0;
+    }
+
+    /// The sign of a number in normal form is the sign of its leading coefficient
+    int NormalForm::Sign() const {
+        if (terms.empty()) { return 0; }
+        return (terms[0].coefficient > 0) ? 1 : -1;
+    }
+
+    double NormalForm::RealPart() const {
+        for (Term const &term : terms) {
+            if (term.exponent->IsZero()) { return term.coefficient; }
+        }
+        return 0.0;
+    }
+
+    /// Three-way comparison
+    ///
+    /// The terms of both numbers are walked from the highest exponent down. The first term where the numbers
+    /// differ decides the order: a higher exponent outweighs any amount of lower ones, so the number whose
+    /// term is "in excess" is greater if the coefficient of that term is positive.
+    ///
+    /// \param a: the first number
+    /// \param b: the second number
+    /// \return negative if a < b, zero if a == b, positive if a > b
+    int NormalForm::Compare(NormalForm const &a, NormalForm const &b) {
+        std::size_t i = 0, j = 0;
+        while (i < a.terms.size() && j < b.terms.size()) {
+            int exponentOrder = Compare(*a.terms[i].exponent, *b.terms[j].exponent);
+            if (exponentOrder > 0) { return (a.terms[i].coefficient > 0) ? 1 : -1; }
+            if (exponentOrder < 0) { return (b.terms[j].coefficient > 0) ? -1 : 1; }
+
+            /// same exponent, compare the coefficients
+            if (a.terms[i].coefficient != b.terms[j].coefficient) {
+                return (a.terms[i].coefficient > b.terms[j].coefficient) ? 1 : -1;
+            }
+            i++;
+            j++;
+        }
+
+        /// one of the numbers ran out of terms, the next term of the other one decides
+        if (i < a.terms.size()) { return (a.terms[i].coefficient > 0) ? 1 : -1; }
+        if (j < b.terms.size()) { return (b.terms[j].coefficient > 0) ? -1 : 1; }
+        return 0;
+    }
+
+    /// Negation
+    ///
+    /// \return the number with every coefficient negated
+    NormalForm NormalForm::operator-() const {
+        NormalForm res = *this;
+        for (Term &term : res.terms) { term.coefficient = -term.coefficient; }
+        return res;
+    }
+
+    /// Arithmetic
+
+    /// Addition
+    /// Merges the terms of both numbers by exponent, adding the coefficients of equal exponents.
+    ///
+    /// \param a: an operand
+    /// \param b: an operand
+    /// \return the sum
+    NormalForm operator+(NormalForm const &a, NormalForm const &b) {
+        NormalForm res;
+        res.terms.reserve(a.terms.size() + b.terms.size());
+
+        std::size_t i = 0, j = 0;
+        while (i < a.terms.size() || j < b.terms.size()) {
+            int exponentOrder;
+            if (i == a.terms.size()) { exponentOrder = -1; }
+            else if (j == b.terms.size()) { exponentOrder = 1; }
+            else { exponentOrder = NormalForm::Compare(*a.terms[i].exponent, *b.terms[j].exponent); }
+
+            if (exponentOrder > 0) {
+                res.terms.push_back(a.terms[i++]);
+            } else if (exponentOrder < 0) {
+                res.terms.push_back(b.terms[j++]);
+            } else {
+                /// equal exponents, the terms are combined and dropped if they cancel out
+                double coefficient = a.terms[i].coefficient + b.terms[j].coefficient;
+                if (coefficient != 0.0) { res.terms.push_back(NormalForm::Term{a.terms[i].exponent, coefficient}); }
+                i++;
+                j++;
+            }
+        }
+        return res;
+    }
+
+    /// Subtraction
+    NormalForm operator-(NormalForm const &a, NormalForm const &b) {
+        /// Implemented using addition and negation
+        return a + (-b);
+    }
+
+    /// Multiplication
+    /// (r * w^x) * (s * w^y) = (r * s) * w^(x + y), and the product distributes over the terms.
+    ///
+    /// \param a: an operand
+    /// \param b: an operand
+    /// \return the product
+    NormalForm operator*(NormalForm const &a, NormalForm const &b) {
+        /// Each row of partial products (one term of a times all of b) is already sorted by exponent,
+        /// so the rows are summed with the merging addition.
+        NormalForm res;
+        for (NormalForm::Term const &termA : a.terms) {
+            NormalForm row;
+            row.terms.reserve(b.terms.size());
+            for (NormalForm::Term const &termB : b.terms) {
+                std::shared_ptr<const NormalForm> exponent;
+                if (termA.exponent->IsZero()) { exponent = termB.exponent; }
+                else if (termB.exponent->IsZero()) { exponent = termA.exponent; }
+                else { exponent = std::make_shared<const NormalForm>(*termA.exponent + *termB.exponent); }
+
+                double coefficient = termA.coefficient * termB.coefficient;
+                if (coefficient != 0.0) { row.terms.push_back(NormalForm::Term{exponent, coefficient}); }
+            }
+            res = res + row;
+        }
+        return res;
+    }
+
+    /// Ordering between numbers in normal form
+    bool operator<=(NormalForm const &a, NormalForm const &b) { return NormalForm::Compare(a, b) <= 0; }
+
+    bool operator>=(NormalForm const &a, NormalForm const &b) { return NormalForm::Compare(a, b) >= 0; }
+
+    bool operator==(NormalForm const &a, NormalForm const &b) { return NormalForm::Compare(a, b) == 0; }
+
+    bool operator!=(NormalForm const &a, NormalForm const &b) { return NormalForm::Compare(a, b) != 0; }
+
+    bool operator>(NormalForm const &a, NormalForm const &b) { return NormalForm::Compare(a, b) > 0; }
+
+    bool operator<(NormalForm const &a, NormalForm const &b) { return NormalForm::Compare(a, b) < 0; }
+
+    /// The exact value of a real number, if it is born early enough to be built as a finite SurrealInf
+    static bool FiniteValue(double real, Dyadic &out) {
+        try {
+            out = Dyadic::FromDouble(real);
+        } catch (std::overflow_error const &) {
+            return false;
+        }
+        return out.Birthday() <= SurrealInf::MaxFiniteBirthday;
+    }
+
+    /// Conversion to SurrealInf
+    ///
+    /// A real number is converted exactly into a finite SurrealInf, unless it is born too late for that.
+    /// Any other number x, whose smallest term has exponent e, is written as
+    ///     x = { x - w^e / 2^n | x + w^e / 2^n }   for n = 0, 1, 2, ...
+    /// Every number strictly between those sets is x plus terms of exponent lower than e, and x is the simplest
+    /// of them, being a truncation of all of them. The terms are converted lazily, only when generated.
+    ///
+    /// \return the SurrealInf, tagged with this normal form
+    SurrealInf NormalForm::ToSurrealInf() const {
+        if (IsZero()) { return SurrealInf(); }
+
+        SurrealInf res;
+        Dyadic value;
+        if (IsReal() && FiniteValue(RealPart(), value)) {
+            res = SurrealInf(value);
+        } else {
+            NormalForm x = *this;
+            std::shared_ptr<const NormalForm> lowest = terms.back().exponent;
+
+            std::function<SurrealInf(int)> tempLeft = [x, lowest](int n) {
+                return (x - NormalForm(std::ldexp(1.0, -n), *lowest)).ToSurrealInf();
+            };
+            std::function<SurrealInf(int)> tempRight = [x, lowest](int n) {
+                return (x + NormalForm(std::ldexp(1.0, -n), *lowest)).ToSurrealInf();
+            };
+            res = SurrealInf(tempLeft, tempRight, std::make_pair(-1, -1));
+        }
+
+        res.generators->normalForm = std::make_shared<const NormalForm>(*this);
+        return res;
+    }
+
+    /// Conversion from SurrealInf
+    ///
+    /// \param number: the number to convert
+    /// \param out: receives the normal form on success
+    /// \return false if the normal form of the number is not known
+    bool NormalForm::FromSurrealInf(SurrealInf &number, NormalForm &out) {
+        if (!number.generators) {
+            /// no generating functions: { | } is zero
+            if (number.leftSize == 0 && number.rightSize == 0) {
+                out = NormalForm();
+                return true;
+            }
+            return false;
+        }
+
+        if (number.generators->normalForm) {
+            out = *number.generators->normalForm;
+            return true;
+        }
+
+        /// numbers with finite sets are real: their exact value is taken from the finite Surreal,
+        /// as long as a double holds it
+        Surreal finite;
+        if (!number.ToSurreal(finite)) { return false; } /// infinite sets somewhere in the tree
+        try {
+            Dyadic value = Dyadic::FromSurreal(finite);
+            double real = value.Double();
+            if (Dyadic::FromDouble(real) != value) { return false; }
+            out = NormalForm(real);
+        } catch (std::overflow_error const &) {
+            return false;
+        }
+        return true;
+    }
+
+    /// Display
+    ///
+    /// \return the terms from the highest exponent down, for example "w^(2) + 3w + -0.5"
+    std::string NormalForm::Print() const {
+        if (terms.empty()) { return "0"; }
+
+        std::ostringstream out;
+        for (std::size_t i = 0; i < terms.size(); i++) {
+            if (i > 0) { out << " + "; }
+
+            Term const &term = terms[i];
+            if (term.exponent->IsZero()) {
+                out << term.coefficient;
+                continue;
+            }
+
+            if (term.coefficient == -1.0) { out << "-"; }
+            else if (term.coefficient != 1.0) { out << term.coefficient; }
+
+            if (*term.exponent == NormalForm(1.0)) { out << "w"; }
+            else { out << "w^(" << term.exponent->Print() << ")"; }
+        }
+        return out.str();
+    }
+
+} // surreals
+
+/// ostream display uses the Print method
+std::ostream &operator<<(std::ostream &os, surreals::NormalForm const &number) {
+    os << number.Print();
+    return os;
+}
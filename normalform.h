@@ -0,0 +1,114 @@
+///
+/// Conway normal form for transfinite surreal numbers.
+///
+/// A number in normal form is a finite sum
+///     r_0 * w^a_0 + r_1 * w^a_1 + ... + r_n * w^a_n
+/// with nonzero real coefficients r_i and strictly decreasing exponents a_0 > a_1 > ... > a_n,
+/// where w stands for Omega and the exponents are themselves numbers in normal form.
+/// For example, Omega is w^1, Epsilon is w^-1, and Omega + 1 is w^1 + 1 * w^0.
+///
+/// Comparison, addition and multiplication work directly on the terms, so transfinite arithmetic
+/// never needs to evaluate generating functions.
+///
+
+#ifndef SURREALS_NORMALFORM_H
+#define SURREALS_NORMALFORM_H
+
+#include "surreals.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace surreals {
+
+    /// A class representing a surreal number in Conway normal form.
+    class NormalForm {
+    public:
+        /// A single term r * w^a. Exponents are immutable and shared between terms.
+        struct Term {
+            std::shared_ptr<const NormalForm> exponent;
+            double coefficient;
+        };
+
+        /// The terms, ordered by strictly decreasing exponent, with no zero coefficients.
+        /// Zero has no terms.
+        std::vector<Term> terms;
+
+        /// Constructors
+        NormalForm();
+
+        explicit NormalForm(double real);
+
+        NormalForm(double coefficient, NormalForm const &exponent);
+
+        /// Omega (w^1)
+        static NormalForm Omega();
+
+        /// Epsilon (w^-1)
+        static NormalForm Epsilon();
+
+        /// Properties
+        bool IsZero() const;
+
+        /// true if the number has no infinite or infinitesimal terms
+        bool IsReal() const;
+
+        /// true if the leading exponent is positive
+        bool IsInfinite() const;
+
+        /// true if the number is nonzero and every exponent is negative
+        bool IsInfinitesimal() const;
+
+        /// sign of the number: -1, 0 or 1
+        int Sign() const;
+
+        /// the coefficient of w^0
+        double RealPart() const;
+
+        /// Three-way comparison: negative if a < b, zero if a == b, positive if a > b
+        static int Compare(NormalForm const &a, NormalForm const &b);
+
+        /// unary minus (negation)
+        NormalForm operator-() const;
+
+        /// Conversion to a SurrealInf. The result remembers this normal form,
+        /// so arithmetic and comparison on it can skip its generating functions.
+        SurrealInf ToSurrealInf() const;
+
+        /// Conversion from a SurrealInf. Succeeds for numbers created by ToSurrealInf (and arithmetic on them),
+        /// and for numbers with finite sets whose exact value a double holds.
+        ///
+        /// \return false if the normal form of the number is not known
+        static bool FromSurrealInf(SurrealInf &number, NormalForm &out);
+
+        /// display, for example "w^2 + 3w - 1/2" is shown as "w^(2) + 3w + -0.5"
+        std::string Print() const;
+    };
+
+    /// Arithmetic between numbers in normal form
+    NormalForm operator+(NormalForm const &a, NormalForm const &b);
+
+    NormalForm operator-(NormalForm const &a, NormalForm const &b);
+
+    NormalForm operator*(NormalForm const &a, NormalForm const &b);
+
+    /// Ordering between numbers in normal form
+    bool operator<=(NormalForm const &a, NormalForm const &b);
+
+    bool operator>=(NormalForm const &a, NormalForm const &b);
+
+    bool operator==(NormalForm const &a, NormalForm const &b);
+
+    bool operator!=(NormalForm const &a, NormalForm const &b);
+
+    bool operator>(NormalForm const &a, NormalForm const &b);
+
+    bool operator<(NormalForm const &a, NormalForm const &b);
+
+} // surreals
+
+/// iostream display
+std::ostream &operator<<(std::ostream &os, surreals::NormalForm const &number);
+
+#endif //SURREALS_NORMALFORM_H
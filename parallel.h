@@ -0,0 +1,64 @@
+///
+/// A minimal helper for running independent pieces of work on several threads.
+///
+
+#ifndef SURREALS_PARALLEL_H
+#define SURREALS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace surreals {
+
+    /// Run body(0), body(1), ..., body(count - 1) on a pool of threads.
+    /// Work items are handed out one at a time from a shared counter, so uneven items balance out.
+    /// The first exception thrown by any item is rethrown on the calling thread once all threads have stopped.
+    ///
+    /// \param count: the amount of work items
+    /// \param threads: the amount of threads to use. 0 picks std::thread::hardware_concurrency(),
+    ///                 1 runs everything on the calling thread.
+    /// \param body: the work to do for each item
+    inline void ParallelFor(std::size_t count, unsigned threads, std::function<void(std::size_t)> const &body) {
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+        if (threads > count) { threads = (unsigned) count; }
+
+        if (threads <= 1) {
+            for (std::size_t i = 0; i < count; i++) { body(i); }
+            return;
+        }
+
+        std::atomic<std::size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto worker = [&]() {
+            std::size_t i;
+            while ((i = next.fetch_add(1)) < count) {
+                try {
+                    body(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) { error = std::current_exception(); }
+                    next = count; /// stop handing out work
+                }
+            }
+        };
+
+        /// the calling thread works too
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; t++) { pool.emplace_back(worker); }
+        worker();
+        for (std::thread &thread : pool) { thread.join(); }
+
+        if (error) { std::rethrow_exception(error); }
+    }
+
+} // surreals
+
+#endif //SURREALS_PARALLEL_H
@@ -0,0 +1,286 @@
+///
+/// Implementations for the brace notation parser.
+///
+
+#include "parse.h"
+#include "dyadic.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace surreals {
+
+    const std::uint32_t SurrealParser::NoId;
+
+    /// Report malformed text, along with where it was found
+    [[noreturn]] static void ParseError(std::string const &what, std::size_t offset) {
+        throw std::runtime_error("Malformed surreal text at offset " + std::to_string(offset) + ": " + what + "!");
+    }
+
+    static bool IsSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    /// Characters that end a float term
+    static bool IsDelimiter(char c) {
+        return IsSpace(c) || c == '{' || c == '}' || c == '|' || c == '@';
+    }
+
+    /// Float terms are built by the Surreal float constructor, which converts the value to an int, and whose
+    /// work grows with the magnitude and with the binary digits after the point. Terms beyond these bounds
+    /// are rejected, so untrusted text can not make it overflow or run for long.
+    static const float MaxTermMagnitude = 1024;
+    static const int MaxTermFractionBits = 32;
+
+    /// Whether a float term has at most MaxTermFractionBits binary digits after the point
+    static bool TermPrecisionInRange(float value) {
+        try {
+            return Dyadic::FromDouble(value).exp <= MaxTermFractionBits;
+        } catch (std::overflow_error const &) {
+            return false;
+        }
+    }
+
+    std::size_t SurrealParser::KeyHash::operator()(std::vector<std::uint32_t> const &key) const {
+        std::uint64_t hash = 1469598103934665603ull; /// FNV-1a over the ids
+        for (std::uint32_t id : key) {
+            hash ^= id;
+            hash *= 1099511628211ull;
+        }
+        return (std::size_t) hash;
+    }
+
+    /// \param key: the amount of left terms, followed by the ids of the left and right terms
+    /// \param offset: where the node ends in the text, for error messages
+    /// \return the id of the node
+    std::uint32_t SurrealParser::Intern(std::vector<std::uint32_t> const &key, std::size_t offset) {
+        std::size_t leftCount = key[0], rightCount = key.size() - 1 - leftCount;
+
+        /// dense tables for the small nodes, grown on demand
+        std::uint32_t *slot = nullptr;
+        if (leftCount == 0 && rightCount == 0) {
+            slot = &zeroId;
+        } else if (leftCount == 1 && rightCount == 0) {
+            if (leftOnlyIds.size() <= key[1]) { leftOnlyIds.resize(nodes.size(), NoId); }
+            slot = &leftOnlyIds[key[1]];
+        } else if (leftCount == 0 && rightCount == 1) {
+            if (rightOnlyIds.size() <= key[1]) { rightOnlyIds.resize(nodes.size(), NoId); }
+            slot = &rightOnlyIds[key[1]];
+        }
+        if (slot != nullptr) {
+            if (*slot == NoId) {
+                std::uint32_t id = Build(key, offset);
+                *slot = id; /// Build does not touch the tables, so the slot is still valid
+            }
+            return *slot;
+        }
+
+        if (leftCount == 1 && rightCount == 1) {
+            std::uint64_t pair = ((std::uint64_t) key[1] << 32) | key[2];
+            auto found = pairIds.find(pair);
+            if (found != pairIds.end()) { return found->second; }
+            std::uint32_t id = Build(key, offset);
+            pairIds.emplace(pair, id);
+            return id;
+        }
+
+        auto found = ids.find(key);
+        if (found != ids.end()) { return found->second; }
+        std::uint32_t id = Build(key, offset);
+        ids.emplace(key, id);
+        return id;
+    }
+
+    std::uint32_t SurrealParser::Build(std::vector<std::uint32_t> const &key, std::size_t offset) {
+        std::set<Surreal> left, right;
+        for (std::size_t i = 1; i < key.size(); i++) {
+            ((i <= key[0]) ? left : right).insert(nodes[key[i]]);
+        }
+        try {
+            nodes.emplace_back(left, right, false);
+        } catch (std::runtime_error const &) {
+            ParseError("a term on the right is not greater than every term on the left", offset);
+        }
+        return (std::uint32_t) (nodes.size() - 1);
+    }
+
+    std::uint32_t SurrealParser::InternFloat(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        auto found = floatIds.find(bits);
+        if (found != floatIds.end()) { return found->second; }
+
+        nodes.emplace_back(value);
+        std::uint32_t id = (std::uint32_t) (nodes.size() - 1);
+        floatIds.emplace(bits, id);
+        return id;
+    }
+
+    /// Read a node name after an "@": a decimal number
+    ///
+    /// \param p: points at the "@", moved past the name
+    /// \param end: the end of the text
+    /// \param begin: the start of the text, for error messages
+    /// \return the name
+    static std::uint32_t ReadName(char const *&p, char const *end, char const *begin) {
+        char const *start = ++p;
+        std::uint64_t name = 0;
+        while (p != end && *p >= '0' && *p <= '9') {
+            name = name * 10 + (std::uint64_t) (*p - '0');
+            if (name > 0xFFFFFFFFull) { ParseError("node name too large", (std::size_t) (start - begin)); }
+            p++;
+        }
+        if (p == start) { ParseError("expected a node name after '@'", (std::size_t) (start - begin)); }
+        return (std::uint32_t) name;
+    }
+
+    /// Look up the node defined under a name
+    std::uint32_t SurrealParser::Named(std::uint32_t name, std::size_t offset) const {
+        auto found = names.find(name);
+        if (found == names.end()) { ParseError("@" + std::to_string(name) + " is not defined", offset); }
+        return found->second;
+    }
+
+    /// The parser keeps a stack of open nodes. Each frame holds the key of the node being read (the amount of
+    /// left terms, then the ids of the terms), and whether the "|" has been read. A closing brace interns the
+    /// node on top of the stack and appends its id to the frame below it.
+    ///
+    /// \param p: points at the opening brace, moved past the closing brace
+    /// \param end: the end of the text
+    /// \param begin: the start of the text, for error messages
+    /// \return the id of the node
+    std::uint32_t SurrealParser::ParseNode(char const *&p, char const *end, char const *begin) {
+        std::size_t used = 0; /// frames in use, the rest are spare buffers
+        auto offset = [begin, &p]() { return (std::size_t) (p - begin); };
+
+        while (p != end) {
+            char c = *p;
+            if (IsSpace(c)) {
+                p++;
+                continue;
+            }
+
+            if (c == '{') {
+                if (used == stack.size()) { stack.emplace_back(); }
+                stack[used].key.assign(1, 0);
+                stack[used].onRight = false;
+                used++;
+                p++;
+                continue;
+            }
+
+            Frame &top = stack[used - 1];
+            if (c == '|') {
+                if (top.onRight) { ParseError("unexpected '|'", offset()); }
+                top.onRight = true;
+                top.key[0] = (std::uint32_t) (top.key.size() - 1);
+                p++;
+            } else if (c == '}') {
+                if (!top.onRight) { ParseError("expected '|' before '}'", offset()); }
+                p++;
+                std::uint32_t id = Intern(top.key, offset());
+                used--;
+                if (used == 0) { return id; }
+                stack[used - 1].key.push_back(id);
+            } else if (c == '@') {
+                /// a reference to a node defined earlier
+                std::size_t at = offset();
+                top.key.push_back(Named(ReadName(p, end, begin), at));
+            } else {
+                /// a float term: copy the token, then convert it
+                char const *tokenEnd = p;
+                while (tokenEnd != end && !IsDelimiter(*tokenEnd)) { tokenEnd++; }
+                std::size_t length = (std::size_t) (tokenEnd - p);
+                if (length == 3 && std::strncmp(p, "...", 3) == 0) {
+                    ParseError("infinite sets can not be parsed into a Surreal", offset());
+                }
+
+                char token[64];
+                if (length >= sizeof(token)) { ParseError("term too long", offset()); }
+                std::memcpy(token, p, length);
+                token[length] = '\0';
+
+                char *parsedEnd;
+                float value = std::strtof(token, &parsedEnd);
+                if (parsedEnd != token + length || !std::isfinite(value)) {
+                    ParseError("expected '{', '|', '}', '@' or a finite float", offset());
+                }
+                if (std::fabs(value) > MaxTermMagnitude) { ParseError("float term too large", offset()); }
+                if (!TermPrecisionInRange(value)) { ParseError("float term too precise", offset()); }
+                top.key.push_back(InternFloat(value));
+                p = tokenEnd;
+            }
+        }
+        ParseError("unexpected end of text", offset());
+    }
+
+    /// At the top level, the text holds numbers in brace notation, node definitions "@k = { ... }",
+    /// and references "@k" to defined nodes. Definitions are recorded and skipped; a number or a reference
+    /// is the result.
+    Surreal const *SurrealParser::Next(char const *&cursor, char const *end) {
+        char const *begin = cursor;
+        char const *p = cursor;
+
+        while (true) {
+            while (p != end && IsSpace(*p)) { p++; }
+            if (p == end) {
+                cursor = p;
+                return nullptr;
+            }
+
+            if (*p == '{') {
+                std::uint32_t id = ParseNode(p, end, begin);
+                cursor = p;
+                return &nodes[id];
+            }
+            if (*p != '@') { ParseError("expected '{' or '@'", (std::size_t) (p - begin)); }
+
+            std::size_t at = (std::size_t) (p - begin);
+            std::uint32_t name = ReadName(p, end, begin);
+            char const *afterName = p;
+            while (p != end && IsSpace(*p)) { p++; }
+            if (p == end || *p != '=') {
+                /// a reference to a defined node
+                p = afterName;
+                std::uint32_t id = Named(name, at);
+                cursor = p;
+                return &nodes[id];
+            }
+
+            /// a definition
+            p++;
+            while (p != end && IsSpace(*p)) { p++; }
+            if (p == end || *p != '{') { ParseError("expected '{'", (std::size_t) (p - begin)); }
+            std::uint32_t id = ParseNode(p, end, begin);
+            names[name] = id; /// a later definition replaces an earlier one, so blocks of PrintDag output can follow each other
+        }
+    }
+
+    bool SurrealParser::Next(char const *&cursor, char const *end, Surreal &number) {
+        Surreal const *parsed = Next(cursor, end);
+        if (parsed == nullptr) { return false; }
+        number = *parsed;
+        return true;
+    }
+
+    Surreal SurrealParser::Parse(std::string const &text) {
+        char const *cursor = text.data();
+        char const *end = text.data() + text.size();
+        Surreal const *res = Next(cursor, end);
+        if (res == nullptr) { ParseError("no number found", text.size()); }
+
+        while (cursor != end && IsSpace(*cursor)) { cursor++; }
+        if (cursor != end) { ParseError("unexpected text after the number", (std::size_t) (cursor - text.data())); }
+        return *res;
+    }
+
+    std::size_t SurrealParser::NodeCount() const {
+        return nodes.size();
+    }
+
+    Surreal ParseSurreal(std::string const &text) {
+        SurrealParser parser;
+        return parser.Parse(text);
+    }
+
+}
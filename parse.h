@@ -0,0 +1,101 @@
+///
+/// Parser for the brace notation written by Surreal::Print and Surreal::PrintVerbose.
+///
+/// The text of a number is "{", the terms of the left set, "|", the terms of the right set, "}", where
+/// each term is either a number in brace notation or a float (as written by Print once it reaches its depth).
+/// Whitespace between the tokens is optional. For example, "{ | }", "{ { | } | }" and "{ 0.500000 | 1.000000 }"
+/// are all valid, and float terms are converted with the Surreal float constructor. A float term must be at most
+/// 1024 in magnitude, with at most 32 binary digits after the point.
+///
+/// The compact form written by Surreal::PrintDag is read as well: a line "@k = { @i @j | @m }" defines the node
+/// named k (terms may be named nodes, numbers in brace notation or floats), and a line "@k" on its own is
+/// the number named k. Names are kept between calls, like the intern table below, and a later definition
+/// of a name replaces the earlier one.
+///
+/// The parser reads the text in a single pass, without recursion: it keeps one frame per open brace.
+/// Every parsed node is interned on the identities of its terms, so a subtree that occurs many times
+/// (which is typical of verbose output) is only built once. The intern table is kept between calls,
+/// so a batch of numbers parsed by one SurrealParser shares the work on the subtrees they have in common.
+///
+
+#ifndef SURREALS_PARSE_H
+#define SURREALS_PARSE_H
+
+#include "surreals.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace surreals {
+
+    /// Parses Surreals in brace notation
+    class SurrealParser {
+    public:
+        /// Parse the next number in [cursor, end), skipping leading whitespace. On success, the cursor is moved
+        /// past the number. Returns false if only whitespace is left. Throws std::runtime_error on malformed text.
+        bool Next(char const *&cursor, char const *end, Surreal &number);
+
+        /// Same as above, without copying the number out: returns the parser's own copy (valid for the lifetime
+        /// of the parser), or nullptr if only whitespace is left. Surreals hold their sets by value, so for large
+        /// numbers the copy takes longer than the parsing itself.
+        Surreal const *Next(char const *&cursor, char const *end);
+
+        /// Parse a text holding exactly one number (and optional whitespace)
+        Surreal Parse(std::string const &text);
+
+        /// How many distinct nodes have been interned
+        std::size_t NodeCount() const;
+
+    private:
+        /// Hash of a node key: the amount of left terms, followed by the ids of the left and right terms
+        struct KeyHash {
+            std::size_t operator()(std::vector<std::uint32_t> const &key) const;
+        };
+
+        /// Intern a finished node, building its Surreal if it is new
+        std::uint32_t Intern(std::vector<std::uint32_t> const &key, std::size_t offset);
+
+        /// Intern a float term
+        std::uint32_t InternFloat(float value);
+
+        /// Parse a node in brace notation
+        std::uint32_t ParseNode(char const *&p, char const *end, char const *begin);
+
+        /// The node defined under a name
+        std::uint32_t Named(std::uint32_t name, std::size_t offset) const;
+
+        /// Build the Surreal of a new node
+        std::uint32_t Build(std::vector<std::uint32_t> const &key, std::size_t offset);
+
+        /// Every distinct node, by id. A deque never moves its elements, so parsed numbers can be handed out.
+        std::deque<Surreal> nodes;
+
+        /// Node ids by key. Nodes with at most one term on each side (most nodes, in practice) are looked up
+        /// in dense tables indexed by the id of the term, and the rest in a hash table.
+        static const std::uint32_t NoId = 0xFFFFFFFF;
+        std::uint32_t zeroId = NoId;
+        std::vector<std::uint32_t> leftOnlyIds; /// { a | } by the id of a
+        std::vector<std::uint32_t> rightOnlyIds; /// { | b } by the id of b
+        std::unordered_map<std::uint64_t, std::uint32_t> pairIds; /// { a | b } by both ids
+        std::unordered_map<std::vector<std::uint32_t>, std::uint32_t, KeyHash> ids;
+        std::unordered_map<std::uint32_t, std::uint32_t> floatIds; /// keyed by the bits of the float
+        std::unordered_map<std::uint32_t, std::uint32_t> names; /// node ids of the "@k = ..." definitions
+
+        /// The open nodes: the key read so far, and whether the "|" has been read.
+        /// Frames are kept between numbers, so that their buffers are reused.
+        struct Frame {
+            std::vector<std::uint32_t> key;
+            bool onRight;
+        };
+        std::vector<Frame> stack;
+    };
+
+    /// Parse a text holding exactly one number in brace notation
+    Surreal ParseSurreal(std::string const &text);
+
+}
+
+#endif //SURREALS_PARSE_H
@@ -0,0 +1,125 @@
+///
+/// Implementations for the binary serialization of Surreals.
+///
+
+#include "serialize.h"
+
+namespace surreals {
+
+    static const char Magic[4] = {'S', 'U', 'R', 'R'};
+
+    /// Record tags
+    static const std::uint64_t NodeTag = 1;
+    static const std::uint64_t RootTag = 2;
+
+    /// Write an unsigned LEB128 varint: 7 bits per byte, lowest first, the high bit set on all but the last byte
+    static void WriteVarint(std::ostream &out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.put((char) ((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.put((char) value);
+    }
+
+    /// Read an unsigned LEB128 varint
+    ///
+    /// \param in: the stream to read from
+    /// \param value: receives the value
+    /// \return false if the stream ended before the first byte
+    static bool ReadVarint(std::istream &in, std::uint64_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = in.get();
+            if (byte == std::char_traits<char>::eof()) {
+                if (shift == 0) { return false; }
+                throw std::runtime_error("Unexpected end of stream while reading a serialized Surreal!");
+            }
+            value |= (std::uint64_t) (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) { return true; }
+        }
+        throw std::runtime_error("Malformed varint while reading a serialized Surreal!");
+    }
+
+    /// Read a varint that must be present
+    static std::uint64_t ReadRequired(std::istream &in) {
+        std::uint64_t value;
+        if (!ReadVarint(in, value)) {
+            throw std::runtime_error("Unexpected end of stream while reading a serialized Surreal!");
+        }
+        return value;
+    }
+
+    /// Writer
+
+    SurrealWriter::SurrealWriter(std::ostream &output) : out(output) {
+        out.write(Magic, sizeof(Magic));
+        WriteVarint(out, Version);
+    }
+
+    /// Nodes are numbered by their structure, so every distinct subtree is written once, after its children.
+    void SurrealWriter::Write(Surreal const &number) {
+        std::uint64_t root = interner.Intern(number, [this](std::size_t id, SurrealInterner::Children const &children,
+                                                            bool isNew, std::size_t) {
+            if (!isNew) { return; }
+            WriteVarint(out, NodeTag);
+            WriteVarint(out, children.first.size());
+            for (std::size_t child : children.first) { WriteVarint(out, id - child); }
+            WriteVarint(out, children.second.size());
+            for (std::size_t child : children.second) { WriteVarint(out, id - child); }
+        });
+        WriteVarint(out, RootTag);
+        WriteVarint(out, root);
+        if (!out) { throw std::runtime_error("Failed to write a serialized Surreal!"); }
+    }
+
+    std::size_t SurrealWriter::NodeCount() const {
+        return interner.Size();
+    }
+
+    /// Reader
+
+    SurrealReader::SurrealReader(std::istream &input) : in(input) {
+        char magic[sizeof(Magic)];
+        in.read(magic, sizeof(magic));
+        if (!in || !std::equal(magic, magic + sizeof(magic), Magic)) {
+            throw std::runtime_error("Not a serialized Surreal stream!");
+        }
+        if (ReadRequired(in) > SurrealWriter::Version) {
+            throw std::runtime_error("Unsupported serialized Surreal version!");
+        }
+    }
+
+    /// Nodes are rebuilt through the checking constructor, so a corrupted stream can not produce pseudo-numbers.
+    bool SurrealReader::Read(Surreal &number) {
+        std::uint64_t tag;
+        while (ReadVarint(in, tag)) {
+            if (tag == RootTag) {
+                std::uint64_t root = ReadRequired(in);
+                if (root >= nodes.size()) { throw std::runtime_error("Bad node index in a serialized Surreal!"); }
+                number = nodes[root];
+                return true;
+            }
+            if (tag != NodeTag) { throw std::runtime_error("Bad record in a serialized Surreal!"); }
+
+            std::uint64_t id = nodes.size();
+            std::set<Surreal> sides[2];
+            for (std::set<Surreal> &side : sides) {
+                std::uint64_t count = ReadRequired(in);
+                for (std::uint64_t i = 0; i < count; i++) {
+                    std::uint64_t distance = ReadRequired(in);
+                    if (distance == 0 || distance > id) {
+                        throw std::runtime_error("Bad node index in a serialized Surreal!");
+                    }
+                    side.insert(nodes[id - distance]);
+                }
+            }
+            nodes.emplace_back(sides[0], sides[1], false);
+        }
+        return false;
+    }
+
+    std::size_t SurrealReader::NodeCount() const {
+        return nodes.size();
+    }
+
+}
@@ -0,0 +1,78 @@
+///
+/// Compact binary serialization of Surreals.
+///
+/// Surreals hold their sets by value, so a number with shared subtrees (like the result of a long
+/// arithmetic chain) is exponentially large when written out as a tree by PrintVerbose.
+/// The binary format writes each distinct subtree once, as a node whose children refer back to
+/// earlier nodes by index, so the size of the output is the size of the DAG instead of the tree.
+///
+/// The stream layout is:
+///     header:  the magic bytes "SURR", then the format version
+///     records: any amount of NODE and ROOT records, until the end of the stream
+///         NODE:  tag 1, the size of the left set, the left children, the size of the right set,
+///                the right children. Nodes are numbered 0, 1, 2, ... in the order they appear, and each
+///                child is written as the distance back from the node being defined (always >= 1).
+///         ROOT:  tag 2, the index of a node. Each ROOT record completes one serialized number.
+/// All integers are unsigned LEB128 varints.
+///
+/// The node table persists for the whole stream, so a batch of numbers written by one SurrealWriter
+/// shares the subtrees they have in common.
+///
+
+#ifndef SURREALS_SERIALIZE_H
+#define SURREALS_SERIALIZE_H
+
+#include "surreals.h"
+#include "intern.h"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace surreals {
+
+    /// Writes Surreals into a binary stream
+    class SurrealWriter {
+    public:
+        /// The version of the format written
+        static const std::uint64_t Version = 1;
+
+        /// Writes the header
+        explicit SurrealWriter(std::ostream &output);
+
+        /// Write one number: the nodes not written yet, then a ROOT record
+        void Write(Surreal const &number);
+
+        /// How many distinct nodes have been written
+        std::size_t NodeCount() const;
+
+    private:
+        std::ostream &out;
+
+        /// The index of each written node, by the structure of its subtree
+        SurrealInterner interner;
+    };
+
+    /// Reads Surreals from a binary stream
+    class SurrealReader {
+    public:
+        /// Reads and checks the header
+        explicit SurrealReader(std::istream &input);
+
+        /// Read the next number. Returns false at the end of the stream.
+        bool Read(Surreal &number);
+
+        /// How many distinct nodes have been read
+        std::size_t NodeCount() const;
+
+    private:
+        std::istream &in;
+
+        /// Every node read so far, by index
+        std::vector<Surreal> nodes;
+    };
+
+}
+
+#endif //SURREALS_SERIALIZE_H
@@ -0,0 +1,127 @@
+///
+/// Implementations for the dense small-birthday lookup tables.
+///
+
+#include "smalltable.h"
+#include "closuretable.h"
+
+namespace surreals {
+
+    const std::uint32_t SmallTable::NoRank;
+
+    void SmallTable::Install(int day, unsigned threads) {
+        Surreal::LookupSmall = std::make_shared<SmallTable>(day, threads);
+    }
+
+    void SmallTable::Uninstall() {
+        Surreal::LookupSmall.reset();
+    }
+
+    /// The cells of a ClosureTable are ranks among its results; those are turned into ranks among the operands
+    SmallTable::SmallTable(int day, unsigned threads) : day(day) {
+        ClosureTable sumTable(ClosureTable::Operation::Sum, day, threads);
+        std::vector<Dyadic> const &operands = sumTable.Operands();
+
+        numbers.reserve(operands.size());
+        for (Dyadic const &value : operands) { numbers.push_back(value.ToSurreal()); }
+
+        auto convert = [&operands](ClosureTable const &table, std::vector<std::uint32_t> &cells) {
+            std::vector<std::uint32_t> byResult;
+            byResult.reserve(table.Results().size());
+            for (Dyadic const &value : table.Results()) {
+                auto found = std::lower_bound(operands.begin(), operands.end(), value);
+                byResult.push_back((found != operands.end() && *found == value)
+                                   ? (std::uint32_t) (found - operands.begin()) : NoRank);
+            }
+            cells.reserve(table.Cells().size());
+            for (std::uint32_t cell : table.Cells()) { cells.push_back(byResult[cell]); }
+        };
+
+        convert(sumTable, sums);
+        convert(ClosureTable(ClosureTable::Operation::Product, day, threads), products);
+    }
+
+    int SmallTable::Day() const {
+        return day;
+    }
+
+    std::size_t SmallTable::Size() const {
+        return numbers.size();
+    }
+
+    std::uint32_t SmallTable::Rank(Surreal const &number) const {
+        return Rank(number, day);
+    }
+
+    /// Positions are 1-based, with 0 and N + 1 standing for an empty left and right side. The earliest born
+    /// position strictly between lo and hi is the least multiple of the greatest power of two that fits there.
+    ///
+    /// \param number: the number to rank
+    /// \param depth: how many more levels the form may be nested
+    /// \return the rank, or NoRank
+    std::uint32_t SmallTable::Rank(Surreal const &number, int depth) const {
+        if (number.left.empty() && number.right.empty()) { return (std::uint32_t) (numbers.size() / 2); }
+        if (depth == 0) { return NoRank; }
+
+        std::uint64_t lo = 0, hi = numbers.size() + 1;
+        if (!number.left.empty()) {
+            std::uint32_t rank = Rank(*number.left.rbegin(), depth - 1);
+            if (rank == NoRank) { return NoRank; }
+            lo = rank + 1;
+        }
+        if (!number.right.empty()) {
+            std::uint32_t rank = Rank(*number.right.begin(), depth - 1);
+            if (rank == NoRank) { return NoRank; }
+            hi = rank + 1;
+        }
+
+        for (int bit = day; bit >= 0; bit--) {
+            std::uint64_t position = ((lo >> bit) + 1) << bit;
+            if (position < hi) { return (std::uint32_t) (position - 1); }
+        }
+        return NoRank; /// lo and hi are neighbours, so the number is born after the day of the table
+    }
+
+    Surreal const &SmallTable::Number(std::uint32_t rank) const {
+        return numbers.at(rank);
+    }
+
+    std::uint32_t SmallTable::Sum(std::uint32_t a, std::uint32_t b) const {
+        return sums[(std::size_t) a * numbers.size() + b];
+    }
+
+    std::uint32_t SmallTable::Product(std::uint32_t a, std::uint32_t b) const {
+        return products[(std::size_t) a * numbers.size() + b];
+    }
+
+    /// Ranks are symmetric around 0
+    std::uint32_t SmallTable::Negation(std::uint32_t a) const {
+        return (std::uint32_t) numbers.size() - 1 - a;
+    }
+
+    int SmallTable::Compare(std::uint32_t a, std::uint32_t b) const {
+        return (a < b) ? -1 : ((a > b) ? 1 : 0);
+    }
+
+    bool SmallTable::Find(std::vector<std::uint32_t> const &cells, Surreal const &a, Surreal const &b,
+                          Surreal &out) const {
+        std::uint32_t rankA = Rank(a);
+        if (rankA == NoRank) { return false; }
+        std::uint32_t rankB = Rank(b);
+        if (rankB == NoRank) { return false; }
+
+        std::uint32_t res = cells[(std::size_t) rankA * numbers.size() + rankB];
+        if (res == NoRank) { return false; }
+        out = numbers[res];
+        return true;
+    }
+
+    bool SmallTable::FindSum(Surreal const &a, Surreal const &b, Surreal &out) const {
+        return Find(sums, a, b, out);
+    }
+
+    bool SmallTable::FindProduct(Surreal const &a, Surreal const &b, Surreal &out) const {
+        return Find(products, a, b, out);
+    }
+
+}
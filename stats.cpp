@@ -0,0 +1,97 @@
+///
+/// Implementations for the runtime statistics.
+///
+
+#include "stats.h"
+
+namespace surreals {
+
+#ifdef SURREALS_STATS
+
+    StatCounters &Counters() {
+        static StatCounters counters;
+        return counters;
+    }
+
+    thread_local std::uint64_t StatDepth::depth = 0;
+
+    StatDepth::StatDepth() {
+        depth++;
+        std::atomic<std::uint64_t> &maxDepth = Counters().maxDepth;
+        std::uint64_t seen = maxDepth.load(std::memory_order_relaxed);
+        while (depth > seen && !maxDepth.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {}
+    }
+
+    StatDepth::~StatDepth() {
+        depth--;
+    }
+
+    bool Stats::Enabled() {
+        return true;
+    }
+
+    Stats Stats::Snapshot() {
+        StatCounters &c = Counters();
+        Stats res;
+        res.addHits = c.addHits.load(std::memory_order_relaxed);
+        res.addMisses = c.addMisses.load(std::memory_order_relaxed);
+        res.addBaseHits = c.addBaseHits.load(std::memory_order_relaxed);
+        res.addSmallHits = c.addSmallHits.load(std::memory_order_relaxed);
+        res.multHits = c.multHits.load(std::memory_order_relaxed);
+        res.multMisses = c.multMisses.load(std::memory_order_relaxed);
+        res.multBaseHits = c.multBaseHits.load(std::memory_order_relaxed);
+        res.multSmallHits = c.multSmallHits.load(std::memory_order_relaxed);
+        res.simplifySteps = c.simplifySteps.load(std::memory_order_relaxed);
+        res.comparisons = c.comparisons.load(std::memory_order_relaxed);
+        res.nodes = c.nodes.load(std::memory_order_relaxed);
+        res.maxDepth = c.maxDepth.load(std::memory_order_relaxed);
+        return res;
+    }
+
+    void Stats::Reset() {
+        StatCounters &c = Counters();
+        for (std::atomic<std::uint64_t> *counter : {&c.addHits, &c.addMisses, &c.addBaseHits, &c.addSmallHits,
+                                                    &c.multHits, &c.multMisses, &c.multBaseHits, &c.multSmallHits,
+                                                    &c.simplifySteps, &c.comparisons, &c.nodes, &c.maxDepth}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+#else
+
+    bool Stats::Enabled() {
+        return false;
+    }
+
+    Stats Stats::Snapshot() {
+        return Stats();
+    }
+
+    void Stats::Reset() {}
+
+#endif
+
+    std::string Stats::ToString() const {
+        std::string res;
+        auto line = [&res](char const *name, std::uint64_t value) {
+            res += name;
+            res += ' ';
+            res += std::to_string(value);
+            res += '\n';
+        };
+        line("add_hits", addHits);
+        line("add_misses", addMisses);
+        line("add_base_hits", addBaseHits);
+        line("add_small_hits", addSmallHits);
+        line("mult_hits", multHits);
+        line("mult_misses", multMisses);
+        line("mult_base_hits", multBaseHits);
+        line("mult_small_hits", multSmallHits);
+        line("simplify_steps", simplifySteps);
+        line("comparisons", comparisons);
+        line("nodes", nodes);
+        line("max_depth", maxDepth);
+        return res;
+    }
+
+}
@@ -0,0 +1,100 @@
+///
+/// Runtime statistics for finite Surreal arithmetic.
+///
+/// The counters are only compiled in when the library is configured with -DSURREALS_STATS=ON; otherwise every
+/// counting site is empty and Stats::Snapshot() returns zeros. Counters are relaxed atomics, so they can be read
+/// while other threads are counting, and a snapshot is a consistent value of each counter, though not of all of
+/// them at one instant.
+///
+
+#ifndef SURREALS_STATS_H
+#define SURREALS_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace surreals {
+
+    /// A snapshot of the counters
+    struct Stats {
+        /// Outcomes of addition and multiplication: found in AddLookup / MultLookup, in the base layer (LookupBase)
+        /// or in the small tables (LookupSmall), or missed everywhere and computed
+        std::uint64_t addHits = 0;
+        std::uint64_t addMisses = 0;
+        std::uint64_t addBaseHits = 0;
+        std::uint64_t addSmallHits = 0;
+        std::uint64_t multHits = 0;
+        std::uint64_t multMisses = 0;
+        std::uint64_t multBaseHits = 0;
+        std::uint64_t multSmallHits = 0;
+
+        /// Entries visited by the scans for a simpler equivalent result, after a miss
+        std::uint64_t simplifySteps = 0;
+
+        /// Calls of operator<= (every other comparison is made of these)
+        std::uint64_t comparisons = 0;
+
+        /// Surreals constructed (each one is a node of some tree)
+        std::uint64_t nodes = 0;
+
+        /// The deepest nesting of operator+ and operator* calls that missed the lookup tables, on any thread
+        std::uint64_t maxDepth = 0;
+
+        /// Whether the counters are compiled in
+        static bool Enabled();
+
+        /// Read the counters
+        static Stats Snapshot();
+
+        /// Set every counter to zero
+        static void Reset();
+
+        /// One "name value" pair per line
+        std::string ToString() const;
+    };
+
+#ifdef SURREALS_STATS
+
+    /// The live counters
+    struct StatCounters {
+        std::atomic<std::uint64_t> addHits{0};
+        std::atomic<std::uint64_t> addMisses{0};
+        std::atomic<std::uint64_t> addBaseHits{0};
+        std::atomic<std::uint64_t> addSmallHits{0};
+        std::atomic<std::uint64_t> multHits{0};
+        std::atomic<std::uint64_t> multMisses{0};
+        std::atomic<std::uint64_t> multBaseHits{0};
+        std::atomic<std::uint64_t> multSmallHits{0};
+        std::atomic<std::uint64_t> simplifySteps{0};
+        std::atomic<std::uint64_t> comparisons{0};
+        std::atomic<std::uint64_t> nodes{0};
+        std::atomic<std::uint64_t> maxDepth{0};
+    };
+
+    StatCounters &Counters();
+
+    /// Counts one level of arithmetic recursion on the current thread for as long as it lives
+    class StatDepth {
+    public:
+        StatDepth();
+
+        ~StatDepth();
+
+    private:
+        static thread_local std::uint64_t depth;
+    };
+
+#define SURREALS_COUNT(counter) (::surreals::Counters().counter.fetch_add(1, std::memory_order_relaxed))
+#define SURREALS_COUNT_DEPTH() ::surreals::StatDepth surrealsStatDepth
+
+#else
+
+#define SURREALS_COUNT(counter) ((void) 0)
+#define SURREALS_COUNT_DEPTH() ((void) 0)
+
+#endif
+
+}
+
+#endif //SURREALS_STATS_H
@@ -3,6 +3,16 @@
 ///
 
 #include "surreals.h"
+#include "dyadic.h"
+#include "intern.h"
+#include "normalform.h"
+#include "memofile.h"
+#include "smalltable.h"
+#include "stats.h"
+#include "trace.h"
+#include "parallel.h"
+
+#include <cstring>
 
 namespace surreals {
 
@@ -16,6 +26,7 @@ namespace surreals {
     Surreal::Surreal(std::set<Surreal> const &leftIn,
                      std::set<Surreal> const &rightIn,
                      bool simplify = true) {
+        SURREALS_COUNT(nodes);
 
         /// Check that no element in the right set is less than or equal to any element in the left set.
         /// This prevents construction of pseudo-numbers.
@@ -43,6 +54,7 @@ namespace surreals {
     ///
     /// \param input: the input integer
     Surreal::Surreal(int const &input) {
+        SURREALS_COUNT(nodes);
         /// When a Surreal number is equivalent to a positive integer N, it has the form
         /// {{ ... {{{ {|} |} |} |} |} |} |} ... |}
         /// It is created on day N and effectively only contains a single zero at depth N,
@@ -73,6 +85,7 @@ namespace surreals {
     ///
     /// \param input: the input floating point number
     Surreal::Surreal(float const &input) {
+        SURREALS_COUNT(nodes);
         /// get floor and ceiling of the input float
         float float_floor = std::floor(input), float_ceil = std::ceil(input);
 
@@ -138,6 +151,7 @@ namespace surreals {
     ///
     /// \param other: the Surreal to be copied
     Surreal::Surreal(Surreal const &other) {
+        SURREALS_COUNT(nodes);
         this->left = other.left;
         this->right = other.right;
     }
@@ -147,6 +161,7 @@ namespace surreals {
     /// \param sur_left: the left side
     /// \param sur_right: the right side
     Surreal::Surreal(const surreals::Surreal &sur_left, const surreals::Surreal &sur_right) {
+        SURREALS_COUNT(nodes);
         if (sur_left < sur_right) { /// check that we're not constructing a pseudo-number
             this->left.emplace(sur_left);
             this->right.emplace(sur_right);
@@ -158,48 +173,21 @@ namespace surreals {
     /// Constructor from a SurrealInf. This construction will only be performed if the SurrealInf has
     /// finite left and right sets. It is recursive, so this restriction applies to every "child" of
     /// the input SurrealInf. If somewhere in the tree there exists an infinite set, an exception will be thrown.
+    /// SurrealInf::ToSurreal performs the same conversion without throwing.
     Surreal::Surreal(SurrealInf &inputSurInf) {
-
-        int leftSize = inputSurInf.leftSize;
-        int rightSize = inputSurInf.rightSize;
-
-        /// throw exception if sets are infinite
-        if (leftSize < 0 || rightSize < 0) {
+        SURREALS_COUNT(nodes);
+        Surreal res;
+        if (!inputSurInf.ToSurreal(res)) {
             throw std::runtime_error("Encountered infinite set in Surreal::Surreal( SurrealInf const &inputSurInf )");
         }
-
-        /// if sets are finite, recursively get the greatest number from L and smallest number from R
-        std::set<Surreal> tempLset, tempRset;
-
-        if (leftSize > 0) {
-            try {
-                SurrealInf tempLinf = inputSurInf.getLeft(leftSize - 1);
-                Surreal tempLfin = Surreal(tempLinf);
-                tempLset.insert(tempLfin);
-            } catch (const std::runtime_error &e) {
-                /// infinite sets in the child, rethrow error
-                throw;
-            }
-        }
-
-        if (rightSize > 0) {
-            try {
-                SurrealInf tempRinf = inputSurInf.getRight(rightSize - 1);
-                Surreal tempRfin = Surreal(tempRinf);
-                tempRset.insert(tempRfin);
-            } catch (const std::runtime_error &e) {
-                /// infinite sets in the child, rethrow error
-                throw;
-            }
-        }
-
-        Surreal res = Surreal(tempLset, tempRset, true);
         this->left = res.left;
         this->right = res.right;
     }
 
     /// Default constructor
-    Surreal::Surreal() = default;
+    Surreal::Surreal() {
+        SURREALS_COUNT(nodes);
+    }
 
     /// Destructor
     Surreal::~Surreal() = default;
@@ -273,6 +261,12 @@ namespace surreals {
     /// The addition lookup table
     std::map<std::pair<Surreal, Surreal>, Surreal> Surreal::AddLookup = std::map<std::pair<Surreal, Surreal>, Surreal>();
 
+    /// The base layer of the lookup tables
+    std::shared_ptr<MemoFile> Surreal::LookupBase;
+
+    /// The dense tables for numbers of small birthday
+    std::shared_ptr<SmallTable> Surreal::LookupSmall;
+
     /// Addition (Binary operator)
     ///
     /// \param a: an operand
@@ -283,11 +277,39 @@ namespace surreals {
         /// skip the calculation and use the lookup value instead. Otherwise, proceed
         /// with the calculation and put the result into the lookup table for later use.
 
+        SURREALS_TRACE_SCOPE(span, "add", a, b);
+
+        /// Numbers of small birthday are answered by the dense tables, without touching the lookup table.
+        /// The result is only constructed when there is a table, so the node count is not inflated otherwise.
+        if (Surreal::LookupSmall) {
+            Surreal small;
+            if (Surreal::LookupSmall->FindSum(a, b, small)) {
+                SURREALS_COUNT(addSmallHits);
+                SURREALS_TRACE_OUTCOME(span, "small");
+                return small;
+            }
+        }
+
         /// Try finding the pair in the lookup table
         auto lookupIter = Surreal::AddLookup.find(std::pair<Surreal, Surreal>(std::minmax(a, b)));
         if (lookupIter != Surreal::AddLookup.end()) {
+            SURREALS_COUNT(addHits);
+            SURREALS_TRACE_OUTCOME(span, "hit");
             return lookupIter->second;
-        } /// the requested pair of operands is not found in the lookup table, proceed with calculation
+        }
+
+        /// Try the mapped base layer, and keep what it finds in the lookup table
+        if (Surreal::LookupBase) {
+            Surreal mapped;
+            if (Surreal::LookupBase->FindSum(a, b, mapped)) {
+                SURREALS_COUNT(addBaseHits);
+                SURREALS_TRACE_OUTCOME(span, "base");
+                Surreal::AddLookup.emplace(std::pair<Surreal, Surreal>(std::minmax(a, b)), mapped);
+                return mapped;
+            }
+        } /// the requested pair of operands is not found in the lookup tables, proceed with calculation
+        SURREALS_COUNT(addMisses);
+        SURREALS_COUNT_DEPTH();
 
         /// Addition on Surreals is defined as
         /// a + b = { Al + b, Bl + a | Ar + b, Br + a }
@@ -315,6 +337,7 @@ namespace surreals {
 
         auto simplIter = Surreal::AddLookup.begin();
         while (simplIter != Surreal::AddLookup.end()) { /// step through the addition lookup table
+            SURREALS_COUNT(simplifySteps);
 
             if (res == simplIter->second) { /// found an equivalent value, check if it is "simpler"
 
@@ -382,11 +405,38 @@ namespace surreals {
         /// skip the calculation and use the lookup value instead. Otherwise, proceed
         /// with the calculation and put the result into the lookup table for later use.
 
+        SURREALS_TRACE_SCOPE(span, "multiply", a, b);
+
+        /// Numbers of small birthday are answered by the dense tables, without touching the lookup table
+        if (Surreal::LookupSmall) {
+            Surreal small;
+            if (Surreal::LookupSmall->FindProduct(a, b, small)) {
+                SURREALS_COUNT(multSmallHits);
+                SURREALS_TRACE_OUTCOME(span, "small");
+                return small;
+            }
+        }
+
         /// Try finding the pair in the lookup table
         auto lookupIter = Surreal::MultLookup.find(std::pair<Surreal, Surreal>(std::minmax(a, b)));
         if (lookupIter != Surreal::MultLookup.end()) {
+            SURREALS_COUNT(multHits);
+            SURREALS_TRACE_OUTCOME(span, "hit");
             return lookupIter->second;
-        } /// the requested pair of operands is not found in the lookup table, proceed with calculation
+        }
+
+        /// Try the mapped base layer, and keep what it finds in the lookup table
+        if (Surreal::LookupBase) {
+            Surreal mapped;
+            if (Surreal::LookupBase->FindProduct(a, b, mapped)) {
+                SURREALS_COUNT(multBaseHits);
+                SURREALS_TRACE_OUTCOME(span, "base");
+                Surreal::MultLookup.emplace(std::pair<Surreal, Surreal>(std::minmax(a, b)), mapped);
+                return mapped;
+            }
+        } /// the requested pair of operands is not found in the lookup tables, proceed with calculation
+        SURREALS_COUNT(multMisses);
+        SURREALS_COUNT_DEPTH();
 
         /// Multiplication on Surreals is defined as
         /// a*b = { Al*b + a*Bl - Al*Bl, Ar*b + a*Br - Ar*Br | Al*b + a*Br - Al*Br, Ar*b + a*Bl - Ar*Bl }
@@ -439,6 +489,7 @@ namespace surreals {
 
         auto simplIter = Surreal::MultLookup.begin();
         while (simplIter != Surreal::MultLookup.end()) {
+            SURREALS_COUNT(simplifySteps);
             if (res == simplIter->second) {
 
                 /// found an equivalent value, check if it is "simpler"
@@ -545,6 +596,7 @@ namespace surreals {
 
     /// less than or equal to
     bool operator<=(Surreal const &a, Surreal const &b) {
+        SURREALS_COUNT(comparisons);
         for (Surreal const &a_left_item : a.left) {
             if (b <= a_left_item) { return false; }
         }
@@ -615,23 +667,123 @@ namespace surreals {
         return this->Float();
     }
 
+    /// Chunked output for the streaming printers. Text is collected in a fixed buffer,
+    /// which is handed to the sink whenever it fills up, and once more at the end.
+    class PrintBuffer {
+    public:
+        explicit PrintBuffer(PrintSink const &sinkIn) : sink(sinkIn) {}
+
+        void Put(char const *text, std::size_t length) {
+            while (length > 0) {
+                std::size_t chunk = std::min(length, sizeof(data) - used);
+                std::copy(text, text + chunk, data + used);
+                used += chunk;
+                text += chunk;
+                length -= chunk;
+                if (used == sizeof(data)) { Flush(); }
+            }
+        }
+
+        void Put(char const *text) { Put(text, std::strlen(text)); }
+
+        void Put(std::string const &text) { Put(text.data(), text.size()); }
+
+        void Flush() {
+            if (used > 0) { sink(data, used); }
+            used = 0;
+        }
+
+    private:
+        PrintSink const &sink;
+        char data[4096];
+        std::size_t used = 0;
+    };
+
+    /// A sink writing into an std::ostream
+    static PrintSink StreamSink(std::ostream &os) {
+        return [&os](char const *text, std::size_t length) { os.write(text, (std::streamsize) length); };
+    }
+
+    /// A sink appending to an std::string
+    static PrintSink StringSink(std::string &str) {
+        return [&str](char const *text, std::size_t length) { str.append(text, length); };
+    }
+
+    /// Walk a Surreal for display, writing "{ " + left terms + "| " + right terms + "}" for every node,
+    /// with a space after each term. Nodes deeper than `depth` are written as floats instead,
+    /// or never, if `verbose` is set.
+    ///
+    /// Instead of recursing, the walk keeps a stack with one frame per level: the node, the side being written
+    /// and the next term on that side. Memory use is then proportional to the depth of the number, and every
+    /// node is written straight into the buffer, so time is linear in the size of the output.
+    static void WriteSurreal(Surreal const &number, PrintBuffer &out, int depth, bool verbose) {
+        struct Frame {
+            Surreal const *node;
+            bool onRight;
+            std::set<Surreal>::const_iterator next;
+            int depth;
+        };
+
+        std::vector<Frame> stack;
+        out.Put("{ ");
+        stack.push_back(Frame{&number, false, number.left.begin(), depth});
+
+        while (!stack.empty()) {
+            Frame &top = stack.back();
+            std::set<Surreal> const &side = top.onRight ? top.node->right : top.node->left;
+
+            if (top.next == side.end()) {
+                if (!top.onRight) {
+                    /// done with the left side
+                    out.Put("| ");
+                    top.onRight = true;
+                    top.next = top.node->right.begin();
+                } else {
+                    /// done with the node, which is a term of the node below it on the stack (if any)
+                    out.Put("}");
+                    stack.pop_back();
+                    if (!stack.empty()) { out.Put(" "); }
+                }
+                continue;
+            }
+
+            /// If we are at "depth 0", swap the terms for their float representations.
+            /// Otherwise, descend into the terms.
+            Surreal const &term = *top.next++;
+            if (verbose || top.depth > 0) {
+                int termDepth = top.depth - 1;
+                out.Put("{ ");
+                stack.push_back(Frame{&term, false, term.left.begin(), termDepth});
+            } else {
+                out.Put(std::to_string(term.Float()));
+                out.Put(" ");
+            }
+        }
+    }
+
+    /// Walk a Surreal for the compact display, writing each distinct node once, children first.
+    /// Nodes are named by their structure, so two subtrees get the same name exactly when they are alike.
+    static void WriteSurrealDag(Surreal const &number, PrintBuffer &out) {
+        SurrealInterner interner;
+        std::size_t root = interner.Intern(number, [&out](std::size_t name, SurrealInterner::Children const &children,
+                                                          bool isNew, std::size_t) {
+            if (!isNew) { return; }
+            out.Put("@" + std::to_string(name) + " = { ");
+            for (std::size_t term : children.first) { out.Put("@" + std::to_string(term) + " "); }
+            out.Put("| ");
+            for (std::size_t term : children.second) { out.Put("@" + std::to_string(term) + " "); }
+            out.Put("}\n");
+        });
+        out.Put("@" + std::to_string(root) + "\n");
+    }
+
     /// Verbose display
     /// Displays the number using only brackets and separators
     ///
     /// \return the string for the verbose form
     std::string Surreal::PrintVerbose() const {
         std::string tempstr;
-        tempstr += "{ ";
-        for (surreals::Surreal const &leftnum : left) {
-            tempstr += leftnum.PrintVerbose();
-            tempstr += " ";
-        }
-        tempstr += "| ";
-        for (surreals::Surreal const &rightnum : right) {
-            tempstr += rightnum.PrintVerbose();
-            tempstr += " ";
-        }
-        tempstr += "}";
+        PrintVerbose(StringSink(tempstr));
         return tempstr;
     }
 
@@ -642,33 +794,345 @@ namespace surreals {
     /// \return
     std::string Surreal::Print(int depth = 0) const {
         std::string tempstr;
+        Print(StringSink(tempstr), depth);
+        return tempstr;
+    }
 
-        tempstr += "{ ";
+    /// Streaming verbose display
+    ///
+    /// \param sink: receives the text
+    void Surreal::PrintVerbose(PrintSink const &sink) const {
+        PrintBuffer out(sink);
+        WriteSurreal(*this, out, 0, true);
+        out.Flush();
+    }
 
-        for (surreals::Surreal const &leftnum : left) {
-            /// If we are at "depth 0", swap the terms for their float representations.
-            /// Otherwise, recursively print the terms.
-            if (depth > 0) { tempstr += leftnum.Print(depth - 1); }
-            else { tempstr += std::to_string(leftnum.Float()); }
-            tempstr += " ";
-        }
+    void Surreal::PrintVerbose(std::ostream &os) const {
+        PrintVerbose(StreamSink(os));
+    }
 
-        tempstr += "| ";
+    /// Compact display
+    ///
+    /// \return the string for the compact form
+    std::string Surreal::PrintDag() const {
+        std::string tempstr;
+        PrintDag(StringSink(tempstr));
+        return tempstr;
+    }
 
-        for (surreals::Surreal const &rightnum : right) {
-            /// If we are at "depth 0", swap the terms for their float representations.
-            /// Otherwise, recursively print the terms.
-            if (depth > 0) { tempstr += rightnum.Print(depth - 1); }
-            else { tempstr += std::to_string(rightnum.Float()); }
-            tempstr += " ";
+    /// Streaming compact display
+    ///
+    /// \param sink: receives the text
+    void Surreal::PrintDag(PrintSink const &sink) const {
+        PrintBuffer out(sink);
+        WriteSurrealDag(*this, out);
+        out.Flush();
+    }
+
+    void Surreal::PrintDag(std::ostream &os) const {
+        PrintDag(StreamSink(os));
+    }
+
+    /// Streaming hybrid display
+    ///
+    /// \param sink: receives the text
+    /// \param depth : at which level the numbers are shortened to floats
+    void Surreal::Print(PrintSink const &sink, int depth) const {
+        PrintBuffer out(sink);
+        WriteSurreal(*this, out, depth, false);
+        out.Flush();
+    }
+
+    void Surreal::Print(std::ostream &os, int depth) const {
+        Print(StreamSink(os), depth);
+    }
+
+    /// Memory accounting
+
+    Footprint &Footprint::operator+=(Footprint const &other) {
+        nodes += other.nodes;
+        bytes += other.bytes;
+        uniqueNodes += other.uniqueNodes;
+        uniqueBytes += other.uniqueBytes;
+        sharedNodes += other.sharedNodes;
+        sharedBytes += other.sharedBytes;
+        return *this;
+    }
+
+    std::string Footprint::ToString() const {
+        std::string res;
+        auto line = [&res](char const *name, std::size_t value) {
+            res += name;
+            res += ' ';
+            res += std::to_string(value);
+            res += '\n';
+        };
+        line("nodes", nodes);
+        line("bytes", bytes);
+        line("unique_nodes", uniqueNodes);
+        line("unique_bytes", uniqueBytes);
+        line("shared_nodes", sharedNodes);
+        line("shared_bytes", sharedBytes);
+        return res;
+    }
+
+    /// The parent and child pointers and the colour of a red-black tree node, as laid out by the common
+    /// implementations of std::set and std::map. The element follows them in the same allocation.
+    static const std::size_t TreeNodeOverhead = 4 * sizeof(void *);
+
+    /// Counts the nodes of Surreals into a Footprint, telling repeated structure apart. Nodes are numbered by
+    /// their structure, and the numbers are kept from one tree to the next, so structure repeated between the
+    /// trees is found as well.
+    class FootprintWalker {
+    public:
+        explicit FootprintWalker(Footprint &res) : res(res) {}
+
+        /// \param root: the tree to count
+        /// \param embedded: whether the root object is a part of something counted already
+        void Add(Surreal const &root, bool embedded) {
+            interner.Intern(root, [this, embedded](std::size_t, SurrealInterner::Children const &, bool isNew,
+                                                   std::size_t depth) {
+                /// terms live in the nodes of their sets, the root wherever it was put
+                std::size_t bytes = (depth > 0) ? TreeNodeOverhead + sizeof(Surreal)
+                                                : (embedded ? 0 : sizeof(Surreal));
+                res.nodes++;
+                res.bytes += bytes;
+                if (isNew) {
+                    res.uniqueNodes++;
+                    res.uniqueBytes += bytes;
+                } else {
+                    res.sharedNodes++;
+                    res.sharedBytes += bytes;
+                }
+            });
         }
 
-        tempstr += "}";
-        return tempstr;
+        /// Count the entries of a lookup table, each holding both operands and the result
+        void AddTable(std::map<std::pair<Surreal, Surreal>, Surreal> const &table) {
+            using Entry = std::map<std::pair<Surreal, Surreal>, Surreal>::value_type;
+            std::size_t entryBytes = table.size() * (TreeNodeOverhead + sizeof(Entry));
+            res.bytes += entryBytes;
+            res.uniqueBytes += entryBytes;
+            for (Entry const &entry : table) {
+                Add(entry.first.first, true);
+                Add(entry.first.second, true);
+                Add(entry.second, true);
+            }
+        }
+
+    private:
+        Footprint &res;
+        SurrealInterner interner;
+    };
+
+    /// Memory held by the number
+    ///
+    /// \return the footprint, the repeated subtrees counted as shared
+    Footprint Surreal::MemoryUsage() const {
+        Footprint res;
+        FootprintWalker(res).Add(*this, false);
+        return res;
+    }
+
+    /// Memory held by a lookup table. The table must not be modified meanwhile.
+    ///
+    /// \param table: AddLookup, MultLookup or a table of the same kind
+    /// \return the footprint, the subtrees repeated across entries counted as shared
+    Footprint Surreal::LookupMemoryUsage(std::map<std::pair<Surreal, Surreal>, Surreal> const &table) {
+        Footprint res;
+        FootprintWalker(res).AddTable(table);
+        return res;
+    }
+
+    /// Memory held by both lookup tables, the subtrees repeated across both counted as shared
+    Footprint Surreal::LookupMemoryUsage() {
+        Footprint res;
+        FootprintWalker walker(res);
+        walker.AddTable(AddLookup);
+        walker.AddTable(MultLookup);
+        return res;
     }
 
     /// "Infinite" Surreals
 
+    /// Term cache bookkeeping shared by all SurrealInfs.
+    ///
+    /// Every Generators registers itself here, so that the global limit can find the least recently used terms
+    /// across all numbers. Each fetch stamps its slot with a tick of a global clock. The lock order is registry
+    /// first, then a side: a side's mutex is never held while taking the registry's, which is why evicted terms
+    /// (whose destruction may unregister Generators) are always released after the locks.
+    struct CacheRegistry {
+        std::mutex mutex;
+        std::unordered_set<SurrealInf::Generators *> members;
+        std::atomic<std::size_t> terms{0};
+        std::atomic<std::size_t> limit{0};
+        std::atomic<std::size_t> defaultLimit{0};
+        std::atomic<unsigned long long> clock{0};
+        std::atomic<unsigned long long> evictions{0};
+    };
+
+    /// The registry is never destroyed, since SurrealInfs with static storage may outlive it otherwise
+    static CacheRegistry &Registry() {
+        static CacheRegistry *registry = new CacheRegistry();
+        return *registry;
+    }
+
+    SurrealInf::Generators::Generators() {
+        CacheRegistry &registry = Registry();
+        left.limit = right.limit = registry.defaultLimit;
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.members.insert(this);
+    }
+
+    SurrealInf::Generators::~Generators() {
+        CacheRegistry &registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.members.erase(this);
+        registry.terms -= left.cached + right.cached;
+    }
+
+    const std::size_t SurrealInf::Side::NoSlot;
+
+    /// Take a cached slot out of the list of a side's slots in order of use. The side's mutex must be held.
+    static void UnlinkSlot(SurrealInf::Side *side, std::size_t n) {
+        std::size_t older = side->olderUse[n], newer = side->newerUse[n];
+        if (older != SurrealInf::Side::NoSlot) { side->newerUse[older] = newer; } else { side->leastRecent = newer; }
+        if (newer != SurrealInf::Side::NoSlot) { side->olderUse[newer] = older; } else { side->mostRecent = older; }
+    }
+
+    /// Stamp a cached slot as fetched just now, moving it to the most recent end of the list.
+    /// The side's mutex must be held.
+    static void TouchSlot(SurrealInf::Side *side, std::size_t n, bool linked) {
+        if (linked) { UnlinkSlot(side, n); }
+        side->olderUse[n] = side->mostRecent;
+        side->newerUse[n] = SurrealInf::Side::NoSlot;
+        if (side->mostRecent != SurrealInf::Side::NoSlot) { side->newerUse[side->mostRecent] = n; }
+        else { side->leastRecent = n; }
+        side->mostRecent = n;
+        side->lastUse[n] = ++Registry().clock;
+    }
+
+    /// Empty one slot of a side, moving its term out. The side's mutex must be held.
+    static void EvictSlot(SurrealInf::Side *side, std::size_t n, std::vector<SurrealInf> &evicted) {
+        evicted.push_back(std::move(side->cache[n]));
+        side->cache[n] = SurrealInf();
+        side->lastUse[n] = 0;
+        UnlinkSlot(side, n);
+        side->cached--;
+
+        CacheRegistry &registry = Registry();
+        registry.terms--;
+        registry.evictions++;
+    }
+
+    /// Evict the least recently used terms of a side until it is within its limit. The side's mutex must be held.
+    static void TrimSide(SurrealInf::Side *side, std::vector<SurrealInf> &evicted) {
+        while (side->limit > 0 && side->cached > side->limit) { EvictSlot(side, side->leastRecent, evicted); }
+    }
+
+    /// Bring the caches of all numbers within the global limit.
+    ///
+    /// Collecting every cached term is linear in the size of the caches, so rather than evicting the single
+    /// oldest term on every insertion, a sweep evicts the oldest terms down to 7/8 of the limit at once.
+    /// If another thread holds the registry, the sweep is left to a later insertion.
+    static void EnforceGlobalLimit() {
+        CacheRegistry &registry = Registry();
+        std::size_t limit = registry.limit;
+        if (limit == 0 || registry.terms <= limit) { return; }
+
+        std::vector<SurrealInf> evicted; /// released once the locks are dropped
+        std::unique_lock<std::mutex> registryLock(registry.mutex, std::try_to_lock);
+        if (!registryLock.owns_lock()) { return; }
+
+        struct Entry {
+            unsigned long long tick;
+            SurrealInf::Side *side;
+            std::size_t index;
+        };
+        std::vector<Entry> entries;
+        for (SurrealInf::Generators *member : registry.members) {
+            for (SurrealInf::Side *side : {&member->left, &member->right}) {
+                std::lock_guard<std::mutex> lock(side->mutex);
+                for (std::size_t i = 0; i < side->lastUse.size(); i++) {
+                    if (side->lastUse[i] != 0) { entries.push_back(Entry{side->lastUse[i], side, i}); }
+                }
+            }
+        }
+
+        std::size_t target = limit - limit / 8;
+        if (entries.size() <= target) { return; }
+        std::size_t excess = entries.size() - target;
+        auto older = [](Entry const &a, Entry const &b) { return a.tick < b.tick; };
+        if (excess < entries.size()) { std::nth_element(entries.begin(), entries.begin() + excess, entries.end(), older); }
+
+        for (std::size_t k = 0; k < excess; k++) {
+            std::lock_guard<std::mutex> lock(entries[k].side->mutex);
+            /// terms fetched since they were collected are in use again, and stay
+            if (entries[k].side->lastUse[entries[k].index] == entries[k].tick) {
+                EvictSlot(entries[k].side, entries[k].index, evicted);
+            }
+        }
+        registryLock.unlock();
+    }
+
+    /// Put a generated term into its slot, unless another thread has filled the slot meanwhile.
+    ///
+    /// \param side: the side to cache the term in
+    /// \param n: the index of the term, not negative
+    /// \param term: the generated term
+    /// \return the cached term
+    static SurrealInf StoreTerm(SurrealInf::Side *side, int n, SurrealInf const &term) {
+        if (n < 0) { throw std::runtime_error("Requested a term with a negative index from a SurrealInf!"); }
+        SurrealInf res;
+        std::vector<SurrealInf> evicted; /// released once the lock is dropped
+        {
+            std::lock_guard<std::mutex> lock(side->mutex);
+            std::size_t slot = (std::size_t) n;
+            if (side->cache.size() <= slot) {
+                side->cache.resize(slot + 1);
+                side->lastUse.resize(slot + 1, 0);
+                side->olderUse.resize(slot + 1, SurrealInf::Side::NoSlot);
+                side->newerUse.resize(slot + 1, SurrealInf::Side::NoSlot);
+            }
+            bool linked = side->lastUse[slot] != 0;
+            if (!linked) {
+                side->cache[slot] = term;
+                side->cached++;
+                Registry().terms++;
+            }
+            TouchSlot(side, slot, linked);
+            res = side->cache[slot];
+            TrimSide(side, evicted);
+        }
+        EnforceGlobalLimit();
+        return res;
+    }
+
+    /// Fetch a term from a side, generating it if it is not cached.
+    ///
+    /// The generator runs without holding the cache's mutex. It may fetch terms of this very side (through a copy
+    /// of the number), and another thread may generate the same term meanwhile, in which case the first one
+    /// to be stored is kept.
+    ///
+    /// \param side: the side to fetch from
+    /// \param n: the index of the term
+    /// \return the term
+    static SurrealInf FetchTerm(SurrealInf::Side *side, int n) {
+        if (side == nullptr) {
+            throw std::runtime_error("Requested a term from a SurrealInf without generating functions!");
+        }
+        if (n < 0) { throw std::runtime_error("Requested a term with a negative index from a SurrealInf!"); }
+        {
+            std::lock_guard<std::mutex> lock(side->mutex);
+            std::size_t slot = (std::size_t) n;
+            if (slot < side->lastUse.size() && side->lastUse[slot] != 0) {
+                TouchSlot(side, slot, true);
+                return side->cache[slot];
+            }
+        }
+        return StoreTerm(side, n, side->generator(n));
+    }
+
     /// Constructor from two generating functions
     ///
     /// \param leftIn: the left generating function
@@ -677,33 +1141,116 @@ namespace surreals {
             std::function<SurrealInf(int)> const &leftIn,
             std::function<SurrealInf(int)> const &rightIn,
             std::pair<int, int> const &sizes) {
-        /// No checks are performed at construction. It is trusted that:
-        /// 1) the left function generates numbers in non-strict ascending order
-        /// 2) the right function generates numbers in non-strict descending order
-        /// 3) any number generated by the right function is greater than any number generated by the left function
-        this->left = leftIn;
-        this->right = rightIn;
+        /// No checks are performed at construction. It is trusted that any number generated by the right function
+        /// is greater than any number generated by the left function. The terms may come in any order.
+        this->generators = std::make_shared<Generators>();
+        this->generators->left.generator = leftIn;
+        this->generators->right.generator = rightIn;
         this->leftSize = sizes.first;
         this->rightSize = sizes.second;
     }
 
+    /// Closed-form sequences
+
+    SurrealInf::Sequence SurrealInf::Sequence::Constant(double value) {
+        return Sequence{Kind::Constant, value, 0};
+    }
+
+    SurrealInf::Sequence SurrealInf::Sequence::Linear(double start, double step) {
+        return Sequence{Kind::Linear, start, step};
+    }
+
+    SurrealInf::Sequence SurrealInf::Sequence::Geometric(double limit, double scale) {
+        return Sequence{Kind::Geometric, limit, scale};
+    }
+
+    double SurrealInf::Sequence::Term(int n) const {
+        switch (kind) {
+            case Kind::Constant:
+                return a;
+            case Kind::Linear:
+                return a + b * n;
+            case Kind::Geometric:
+                return a + std::ldexp(b, -n);
+            default:
+                throw std::runtime_error("The terms of a generating function are not known in closed form!");
+        }
+    }
+
+    double SurrealInf::Sequence::Limit() const {
+        if (kind == Kind::Linear && b != 0) { return (b > 0) ? INFINITY : -INFINITY; }
+        return a;
+    }
+
+    bool SurrealInf::Sequence::LimitReached() const {
+        return kind == Kind::Constant || b == 0;
+    }
+
+    bool SurrealInf::Sequence::Ascending() const {
+        return kind == Kind::Constant || (kind == Kind::Linear && b >= 0) || (kind == Kind::Geometric && b <= 0);
+    }
+
+    bool SurrealInf::Sequence::Descending() const {
+        return kind == Kind::Constant || (kind == Kind::Linear && b <= 0) || (kind == Kind::Geometric && b >= 0);
+    }
+
+    /// Constructor from two closed-form sequences
+    ///
+    /// Unlike generating functions, sequences can be checked: the left one must ascend, the right one must
+    /// descend, and the left terms must stay below the right terms.
+    ///
+    /// \param leftIn: the left sequence
+    /// \param rightIn: the right sequence
+    /// \param sizes: the amount of terms on each side, -1 for infinite
+    SurrealInf::SurrealInf(Sequence const &leftIn, Sequence const &rightIn, std::pair<int, int> const &sizes) {
+        bool hasLeft = sizes.first != 0, hasRight = sizes.second != 0;
+        if ((hasLeft && (leftIn.kind == Sequence::Kind::Function || !leftIn.Ascending())) ||
+            (hasRight && (rightIn.kind == Sequence::Kind::Function || !rightIn.Descending()))) {
+            throw std::runtime_error("Bad input sequences during surreal number creation!");
+        }
+
+        Sequence leftSeq = leftIn, rightSeq = rightIn;
+        this->generators = std::make_shared<Generators>();
+        this->generators->left.generator = [leftSeq](int n) { return NormalForm(leftSeq.Term(n)).ToSurrealInf(); };
+        this->generators->right.generator = [rightSeq](int n) { return NormalForm(rightSeq.Term(n)).ToSurrealInf(); };
+        this->generators->left.sequence = hasLeft ? leftIn : Sequence();
+        this->generators->right.sequence = hasRight ? rightIn : Sequence();
+        this->leftSize = sizes.first;
+        this->rightSize = sizes.second;
+
+        /// the bounds of the sides must not cross
+        if (hasLeft && hasRight) {
+            double sup = (sizes.first > 0) ? leftIn.Term(sizes.first - 1) : leftIn.Limit();
+            double inf = (sizes.second > 0) ? rightIn.Term(sizes.second - 1) : rightIn.Limit();
+            bool supReached = (sizes.first > 0) || leftIn.LimitReached();
+            bool infReached = (sizes.second > 0) || rightIn.LimitReached();
+            if (sup > inf || (sup == inf && supReached && infReached)) {
+                throw std::runtime_error("Bad input sequences during surreal number creation!");
+            }
+        }
+    }
+
     /// Constructs an "infinite" Surreal using a finite Surreal
     /// For each side, the generating function will output either a single number or nothing
     SurrealInf::SurrealInf(Surreal const &inputSur) {
         /// Take the greatest number on the left and the smallest number on the right (if the corresponding sets
         /// are not empty), recursively convert them into SurrealInf, then specify the generating functions
-        /// to return those numbers.
+        /// to return those numbers. The only term of each side is known up front, so it is cached right away.
+
+        this->leftSize = 0;
+        this->rightSize = 0;
+        if (inputSur.left.empty() && inputSur.right.empty()) { return; } /// zero has no terms to hold
+
+        this->generators = std::make_shared<Generators>();
 
         if (!inputSur.left.empty()) {
             /// left side of input Surreal isn't empty, specify the generating function
             SurrealInf leftNumber = SurrealInf(*(inputSur.left.rbegin()));
             std::function<SurrealInf(int)> tempLeft = [leftNumber](int) { return leftNumber; };
 
-            this->left = tempLeft;
+            this->generators->left.generator = tempLeft;
+            StoreTerm(&this->generators->left, 0, leftNumber);
             this->leftSize = 1;
-
-        } else {
-            this->leftSize = 0;
         }
 
         if (!inputSur.right.empty()) {
@@ -711,19 +1258,65 @@ namespace surreals {
             SurrealInf rightNumber = SurrealInf(*(inputSur.right.begin()));
             std::function<SurrealInf(int)> tempRight = [rightNumber](int) { return rightNumber; };
 
-            this->right = tempRight;
+            this->generators->right.generator = tempRight;
+            StoreTerm(&this->generators->right, 0, rightNumber);
             this->rightSize = 1;
-
-        } else {
-            this->rightSize = 0;
         }
     }
 
-    /// SurrealInf float constructor chained to the Surreal float constructor
-    SurrealInf::SurrealInf(float const &inputFloat) : SurrealInf::SurrealInf(Surreal(inputFloat)) {}
+    /// SurrealInf float constructor. A float is a dyadic value, built along its sign expansion; one born too late
+    /// for that is chained to the Surreal float constructor. (The Surreal of a float with many fraction bits has
+    /// a tree exponential in their count.)
+    /// The value is known exactly, so it is kept as a normal form.
+    SurrealInf::SurrealInf(float const &inputFloat) {
+        Dyadic value;
+        bool isDyadic = true;
+        try {
+            value = Dyadic::FromDouble(inputFloat);
+        } catch (std::overflow_error const &) {
+            isDyadic = false;
+        }
+        bool early = isDyadic && value.Birthday() <= MaxFiniteBirthday;
+        *this = early ? SurrealInf(value) : SurrealInf(Surreal(inputFloat));
+        if (generators) { generators->normalForm = std::make_shared<const NormalForm>((double) inputFloat); }
+    }
 
     /// SurrealInf int constructor chained to the Surreal int constructor
-    SurrealInf::SurrealInf(int const &inputInt) : SurrealInf::SurrealInf(Surreal(inputInt)) {}
+    /// The value is known exactly, so it is kept as a normal form.
+    SurrealInf::SurrealInf(int const &inputInt) : SurrealInf::SurrealInf(Surreal(inputInt)) {
+        if (generators) { generators->normalForm = std::make_shared<const NormalForm>((double) inputInt); }
+    }
+
+    /// Each step of the sign expansion replaces one of the bounds with the current number, as in Dyadic::ToSurreal.
+    /// The value is kept as a normal form if a double holds it exactly.
+    SurrealInf::SurrealInf(Dyadic const &value) {
+        SurrealInf lo, hi;
+        bool hasLo = false, hasHi = false;
+        for (bool up : value.SignExpansion()) {
+            if (up) {
+                lo = *this;
+                hasLo = true;
+            } else {
+                hi = *this;
+                hasHi = true;
+            }
+            SurrealInf leftNumber = lo, rightNumber = hi;
+            std::function<SurrealInf(int)> tempLeft, tempRight;
+            if (hasLo) { tempLeft = [leftNumber](int) { return leftNumber; }; }
+            if (hasHi) { tempRight = [rightNumber](int) { return rightNumber; }; }
+            *this = SurrealInf(tempLeft, tempRight, std::make_pair(hasLo ? 1 : 0, hasHi ? 1 : 0));
+        }
+
+        if (!generators) { return; } /// zero
+        try {
+            double real = value.Double();
+            if (Dyadic::FromDouble(real) == value) {
+                generators->normalForm = std::make_shared<const NormalForm>(real);
+            }
+        } catch (std::overflow_error const &) {
+            /// the double rounded out of range
+        }
+    }
 
     /// Default constructor
     SurrealInf::SurrealInf() = default;
@@ -733,25 +1326,60 @@ namespace surreals {
 
     /// "Get" functions for "infinite" Surreals
 
+    /// Find one side of a SurrealInf's shared generator state.
+    ///
+    /// \param generators: the shared state, which is empty for a default constructed number
+    /// \param isLeft: whether to return the left or the right side
+    /// \return the side, or nullptr if the number has no generators
+    static SurrealInf::Side *SideOf(std::shared_ptr<SurrealInf::Generators> const &generators, bool isLeft) {
+        if (!generators) { return nullptr; }
+        return isLeft ? &generators->left : &generators->right;
+    }
+
+    /// Make sure the first `count` terms of a side have been generated.
+    /// With a cache limit in place, some of them may be evicted again right away.
+    static void FillCache(SurrealInf::Side *side, int count) {
+        for (int i = 0; i < count; i++) { FetchTerm(side, i); }
+    }
+
+    /// List the indices below `count` that are not cached on a side
+    static std::vector<int> MissingTerms(SurrealInf::Side *side, int count) {
+        std::vector<int> res;
+        std::lock_guard<std::mutex> lock(side->mutex);
+        for (int i = 0; i < count; i++) {
+            if ((std::size_t) i >= side->lastUse.size() || side->lastUse[(std::size_t) i] == 0) { res.push_back(i); }
+        }
+        return res;
+    }
+
+    /// How many terms at the start of a side are cached without a gap
+    static int CachedPrefix(SurrealInf::Side *side) {
+        if (side == nullptr) { return 0; }
+        std::lock_guard<std::mutex> lock(side->mutex);
+        int res = 0;
+        while ((std::size_t) res < side->lastUse.size() && side->lastUse[(std::size_t) res] != 0) { res++; }
+        return res;
+    }
+
+    /// How many more terms can be generated on a side, clamped to k.
+    ///
+    /// \param size: the size of the side (-1 for infinite)
+    /// \param cached: how many terms are cached already
+    /// \param k: the requested amount of terms
+    static int ClampPrefetch(int size, int cached, int k) {
+        if (size < 0) { return cached + k; } /// infinite side, anything goes
+        return std::min(size, cached + k);
+    }
+
     /// Get Nth element of the left set.
     /// This method is not const, since the SurrealInf caches the result of the fetch.
     ///
     /// \param n: the requested index
     /// \return the Nth generated element
     SurrealInf SurrealInf::getLeft(int const &n) {
-
-        /// Check the cache for the requested integer. If not found,
-        /// generate the number, cache it and return it.
-        auto cacheIter = leftCache.find(n);
-
-        if (cacheIter != leftCache.end()) {
-            /// number generated previously, return the cached value
-            return cacheIter->second;
-        } /// number not generated previously
-
-        SurrealInf result = left(n);
-        leftCache[n] = result;
-        return result;
+        /// Read the term from the cache, generating it if needed.
+        /// The returned copy shares its generators with the cached term.
+        return FetchTerm(SideOf(generators, true), n);
     }
 
     /// Get Nth element of the right set
@@ -760,140 +1388,1054 @@ namespace surreals {
     /// \param n: the requested index
     /// \return the Nth generated element
     SurrealInf SurrealInf::getRight(int const &n) {
-        /// Check the cache for the requested integer. If not found,
-        /// generate the number, cache it and return it.
+        /// Read the term from the cache, generating it if needed.
+        /// The returned copy shares its generators with the cached term.
+        return FetchTerm(SideOf(generators, false), n);
+    }
 
-        auto cacheIter = rightCache.find(n);
+    /// Generate the next K terms of the left set in one go.
+    /// For a finite set, generation stops at the last term.
+    ///
+    /// \param k: how many terms to generate
+    void SurrealInf::PrefetchLeft(int const &k) {
+        SurrealInf::Side *side = SideOf(generators, true);
+        FillCache(side, ClampPrefetch(leftSize, CachedPrefix(side), k));
+    }
 
-        if (cacheIter != rightCache.end()) {
-            /// number generated previously, return the cached value
-            return cacheIter->second;
-        } /// number not generated previously
+    /// Generate the next K terms of the right set in one go.
+    /// For a finite set, generation stops at the last term.
+    ///
+    /// \param k: how many terms to generate
+    void SurrealInf::PrefetchRight(int const &k) {
+        SurrealInf::Side *side = SideOf(generators, false);
+        FillCache(side, ClampPrefetch(rightSize, CachedPrefix(side), k));
+    }
 
-        SurrealInf result = right(n);
-        rightCache[n] = result;
-        return result;
+    /// Limit how many terms are cached on each side of this number. Terms over the limit are evicted right away.
+    ///
+    /// \param terms: the limit, 0 for no limit
+    void SurrealInf::SetCacheLimit(std::size_t terms) {
+        if (!generators) { return; } /// zero caches nothing
+        std::vector<SurrealInf> evicted; /// released once the locks are dropped
+        for (SurrealInf::Side *side : {&generators->left, &generators->right}) {
+            std::lock_guard<std::mutex> lock(side->mutex);
+            side->limit = terms;
+            TrimSide(side, evicted);
+        }
     }
 
-    /// Converts the SurrealInf into a Surreal, then converts that into a float. If the conversion to
-    /// Surreal fails, returns NaN.
-    float SurrealInf::Float() {
-        try {
-            Surreal temp = Surreal(*this);
-            return temp.Float();
-        } catch (const std::runtime_error &e) {
-            return NAN;
+    /// How many terms are cached on both sides of this number (not counting the caches of the terms)
+    std::size_t SurrealInf::CachedTerms() const {
+        if (!generators) { return 0; }
+        std::size_t res = 0;
+        for (SurrealInf::Side *side : {&generators->left, &generators->right}) {
+            std::lock_guard<std::mutex> lock(side->mutex);
+            res += side->cached;
         }
+        return res;
     }
 
-    /// Hybrid display for SurrealInf
-    /// Prints the number using brackets and separators, shortening the children to floats after a set depth.
+    /// Limit how many terms are cached on each side of numbers created from now on, including arithmetic
+    /// results and generated terms. Numbers that exist already keep their limits.
+    ///
+    /// \param terms: the limit, 0 for no limit
+    void SurrealInf::SetDefaultCacheLimit(std::size_t terms) {
+        Registry().defaultLimit = terms;
+    }
+
+    /// Limit how many terms are cached across all numbers. Once over the limit, the least recently used terms
+    /// of any number are evicted, down to 7/8 of the limit.
+    ///
+    /// \param terms: the limit, 0 for no limit
+    void SurrealInf::SetGlobalCacheLimit(std::size_t terms) {
+        Registry().limit = terms;
+        EnforceGlobalLimit();
+    }
+
+    /// Report how many numbers and terms are cached
+    SurrealInf::CacheOccupancy SurrealInf::GlobalCacheOccupancy() {
+        CacheRegistry &registry = Registry();
+        CacheOccupancy res;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            res.objects = registry.members.size();
+        }
+        res.terms = registry.terms;
+        res.limit = registry.limit;
+        res.evictions = registry.evictions;
+        return res;
+    }
+
+    /// Bytes of a normal form and of the exponents of its terms, each one counted once
+    static std::size_t NormalFormBytes(NormalForm const &form, std::unordered_set<NormalForm const *> &seen) {
+        if (!seen.insert(&form).second) { return 0; }
+        std::size_t res = sizeof(NormalForm) + form.terms.capacity() * sizeof(NormalForm::Term);
+        for (NormalForm::Term const &term : form.terms) {
+            if (term.exponent) { res += NormalFormBytes(*term.exponent, seen); }
+        }
+        return res;
+    }
+
+    /// Memory held by the number: the generator states reached through the term caches, each counted once with
+    /// its caches, normal form and memoized finite conversion. A state is shared if anything besides the number
+    /// or cache slot it was reached through holds it too: a copy of a number, or a generating function.
+    ///
+    /// \return the footprint
+    Footprint SurrealInf::MemoryUsage() const {
+        Footprint res;
+        FootprintWalker walker(res); /// the finite conversions, with structure repeated between them as shared
+        std::unordered_set<Generators const *> seen;
+        std::unordered_set<NormalForm const *> seenForms;
+
+        std::vector<std::shared_ptr<Generators>> stack;
+        if (generators) { stack.push_back(generators); }
+        while (!stack.empty()) {
+            std::shared_ptr<Generators> node = std::move(stack.back());
+            stack.pop_back();
+            bool shared = node.use_count() > 2; /// the holder it was reached through, and the walk itself
+            if (!seen.insert(node.get()).second) { continue; }
+
+            std::size_t bytes = sizeof(Generators);
+            for (Side *side : {&node->left, &node->right}) {
+                std::lock_guard<std::mutex> lock(side->mutex);
+                bytes += side->cache.capacity() * sizeof(SurrealInf) +
+                         side->lastUse.capacity() * sizeof(unsigned long long) +
+                         (side->olderUse.capacity() + side->newerUse.capacity()) * sizeof(std::size_t);
+                for (SurrealInf const &term : side->cache) {
+                    if (term.generators) { stack.push_back(term.generators); }
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(node->conversionMutex);
+                if (node->normalForm) { bytes += NormalFormBytes(*node->normalForm, seenForms); }
+                if (node->finiteness == Generators::Finiteness::Finite) { walker.Add(node->finite, true); }
+            }
+
+            res.nodes++;
+            res.bytes += bytes;
+            if (shared) {
+                res.sharedNodes++;
+                res.sharedBytes += bytes;
+            } else {
+                res.uniqueNodes++;
+                res.uniqueBytes += bytes;
+            }
+        }
+        return res;
+    }
+
+    /// Parallel prefetch
+    ///
+    /// Generates every term that Print(width, depth) displays, level by level: the missing terms of all numbers
+    /// on one level are generated concurrently, committed to their caches, and then become the
+    /// numbers of the next level. One more level than `depth` is generated, since the terms at the deepest
+    /// printed level are converted to floats.
+    ///
+    /// \param width: how many terms are generated in infinite sets
+    /// \param depth: how many levels below this one are displayed
+    /// \param threads: the amount of threads to use, 0 for one per hardware thread
+    void SurrealInf::Prefetch(int width, int depth, unsigned threads) {
+
+        /// a missing term: which side it belongs to, and its index
+        struct Task {
+            SurrealInf::Side *side;
+            int index;
+        };
+
+        std::vector<SurrealInf> level = {*this};
+        for (int d = 0; d <= depth + 1 && !level.empty(); d++) {
+
+            /// collect the missing terms of every distinct number on this level
+            std::vector<Task> tasks;
+            std::vector<std::pair<SurrealInf::Side *, int>> sides; /// each side and its displayed term count
+            std::set<SurrealInf::Generators *> seen;
+
+            for (SurrealInf const &number : level) {
+                if (!number.generators || !seen.insert(number.generators.get()).second) { continue; }
+
+                int leftCount = (number.leftSize >= 0) ? number.leftSize : std::max(width, 0);
+                int rightCount = (number.rightSize >= 0) ? number.rightSize : std::max(width, 0);
+
+                /// sides in closed form are printed straight from the formula at the last level
+                for (SurrealInf::Side *side : {&number.generators->left, &number.generators->right}) {
+                    bool closed = side->sequence.kind != SurrealInf::Sequence::Kind::Function;
+                    if (d >= depth && closed) { continue; }
+                    sides.emplace_back(side, (side == &number.generators->left) ? leftCount : rightCount);
+                }
+            }
+            for (auto const &side : sides) {
+                for (int i : MissingTerms(side.first, side.second)) { tasks.push_back(Task{side.first, i}); }
+            }
+
+            /// generate them concurrently
+            std::vector<SurrealInf> results(tasks.size());
+            ParallelFor(tasks.size(), threads, [&tasks, &results](std::size_t k) {
+                results[k] = tasks[k].side->generator(tasks[k].index);
+            });
+
+            /// commit, skipping terms another fetch has cached meanwhile
+            for (std::size_t k = 0; k < tasks.size(); k++) { StoreTerm(tasks[k].side, tasks[k].index, results[k]); }
+
+            /// the displayed terms make up the next level. Terms evicted since their commit are generated again.
+            std::vector<SurrealInf> nextLevel;
+            for (auto const &side : sides) {
+                for (int i = 0; i < side.second; i++) { nextLevel.push_back(FetchTerm(side.first, i)); }
+            }
+            level.swap(nextLevel);
+        }
+    }
+
+    /// Hybrid display, with the displayed terms generated concurrently beforehand
     ///
     /// \param width: how many terms are computed in infinite sets
     /// \param depth: at which level the numbers are shortened to floats
+    /// \param threads: the amount of threads to use, 0 for one per hardware thread
     /// \return the string to display
-    std::string SurrealInf::Print(int width = 5, int depth = 0) {
-        std::string tempstr; /// temporary string we write to
+    std::string SurrealInf::Print(int width, int depth, unsigned threads) {
+        Prefetch(width, depth, threads);
+        return Print(width, depth);
+    }
+
+    /// Arithmetic on "infinite" Surreals
+    ///
+    /// The Conway formulas build each side of the result as a union of sets derived from the operands' sides.
+    /// Every such set is a sequence of lazily built SurrealInfs, and the sequences of one side are merged into a
+    /// single generating function. Terms of the result are only evaluated when fetched, and are then memoized in
+    /// the result's shared cache like any other generated term.
+
+    /// Simplest real number strictly between two reals, either of which may be infinite.
+    /// Prefers zero, then the integer closest to zero, then the dyadic fraction with the smallest denominator.
+    static double SimplestBetween(double lo, double hi) {
+        if (lo < 0 && hi > 0) { return 0; }
+        if (hi <= 0) { return -SimplestBetween(-hi, -lo); }
+        if (std::isinf(lo)) { return lo; } /// lo == +inf: nothing is in between, the number is infinite
+
+        /// 0 <= lo < hi: try the smallest integer greater than lo
+        double floor = std::floor(lo);
+        if (floor + 1 < hi) { return floor + 1; }
+
+        /// no integer in between: bisect the unit interval around lo
+        double a = floor, b = floor + 1;
+        for (int i = 0; i < 1100; i++) {
+            double mid = (a + b) / 2;
+            if (mid <= lo) { a = mid; }
+            else if (mid >= hi) { b = mid; }
+            else { return mid; }
+        }
+        return lo; /// the interval is too narrow for a double
+    }
 
-        tempstr += "{ ";
+    /// The day on which a real number (a dyadic fraction, as every double is) is born.
+    /// An integer n is born on day |n|, and every binary digit after the point adds a day.
+    static double Birthday(double value) {
+        value = std::fabs(value);
+        double whole = std::floor(value), fraction = value - whole;
+        int digits = 0;
+        while (fraction != 0) {
+            fraction *= 2;
+            fraction -= std::floor(fraction);
+            digits++;
+        }
+        return (digits > 0) ? whole + 1 + digits : whole;
+    }
+
+    /// Simplest real number in an interval whose ends may or may not belong to it
+    static double SimplestIn(double lo, bool loClosed, double hi, bool hiClosed) {
+        double res = SimplestBetween(lo, hi);
+        if (loClosed && !std::isinf(lo) && Birthday(lo) < Birthday(res)) { res = lo; }
+        if (hiClosed && !std::isinf(hi) && Birthday(hi) < Birthday(res)) { res = hi; }
+        return res;
+    }
+
+    /// The bound of one side of a SurrealInf described by a closed-form sequence: the greatest left term
+    /// (or the smallest right term), and whether some term reaches it. Finite sides are bounded by their last
+    /// term, infinite ones by the limit of the sequence. An empty side is bounded by -/+ infinity.
+    ///
+    /// \return false if the side is not described in closed form
+    static bool SideBound(SurrealInf const &x, bool isLeft, double &bound, bool &reached) {
+        int size = isLeft ? x.leftSize : x.rightSize;
+        if (size == 0) {
+            bound = isLeft ? -INFINITY : INFINITY;
+            reached = false;
+            return true;
+        }
+        if (!x.generators) { return false; }
 
-        /// Print left side
-        if (leftSize > 0) { /// left side has finite, nonzero size.
-            for (int i = 0; i < leftSize; i++) {
-                /// If we are at "depth 0", swap the terms for their float representations.
-                /// Otherwise, recursively print the terms.
-                if (depth > 0) { tempstr += getLeft(i).Print(width, depth - 1); }
-                else { tempstr += std::to_string(getLeft(i).Float()); }
-                tempstr += " ";
+        SurrealInf::Sequence const &seq = isLeft ? x.generators->left.sequence : x.generators->right.sequence;
+        if (seq.kind == SurrealInf::Sequence::Kind::Function) { return false; }
+
+        bound = (size > 0) ? seq.Term(size - 1) : seq.Limit();
+        reached = (size > 0) || seq.LimitReached();
+        return true;
+    }
+
+    /// The value of a SurrealInf whose sides are both described in closed form.
+    ///
+    /// With sup the bound of the left side and inf the bound of the right side, the number is the simplest one
+    /// above every left term and below every right term. A bound reached by no term belongs to the gap itself,
+    /// so sequences converging to the same real c from both sides make c exactly. A bound reached by a term
+    /// is excluded, and if nothing real is left in the gap, the number is c plus or minus an infinitesimal.
+    ///
+    /// \return false if the sides are not both in closed form
+    static bool SequenceValue(SurrealInf const &x, NormalForm &out) {
+        double sup, inf;
+        bool supReached, infReached;
+        if (!SideBound(x, true, sup, supReached) || !SideBound(x, false, inf, infReached)) { return false; }
+
+        if (sup == INFINITY || inf == -INFINITY) {
+            /// a side grows without bound: Omega { 0, 1, 2, ... | } or -Omega { | ..., -2, -1, 0 }
+            if (sup == INFINITY && inf == INFINITY) { out = NormalForm::Omega(); }
+            else if (sup == -INFINITY && inf == -INFINITY) { out = -NormalForm::Omega(); }
+            else { return false; }
+            return true;
+        }
+
+        if (sup < inf) {
+            out = NormalForm(SimplestIn(sup, !supReached, inf, !infReached));
+        } else if (!supReached && !infReached) {
+            out = NormalForm(sup); /// both sides converge to the same real number
+        } else if (supReached) {
+            out = NormalForm(sup) + NormalForm::Epsilon(); /// { c | ..., c + 1/4, c + 1/2 } = c + Epsilon
+        } else {
+            out = NormalForm(sup) - NormalForm::Epsilon(); /// { c - 1/2, c - 1/4, ... | c } = c - Epsilon
+        }
+        return true;
+    }
+
+    /// Look up the normal form of a SurrealInf without evaluating any terms.
+    ///
+    /// \param x: the number
+    /// \param out: receives the normal form if known
+    /// \return whether the normal form is known
+    static bool KnownNormalForm(SurrealInf const &x, NormalForm &out) {
+        if (!x.generators) {
+            if (x.leftSize != 0 || x.rightSize != 0) { return false; }
+            out = NormalForm(); /// { | } is zero
+            return true;
+        }
+        if (x.generators->normalForm) {
+            out = *x.generators->normalForm;
+            return true;
+        }
+        return SequenceValue(x, out); /// sides given in closed form
+    }
+
+    /// Arithmetic on real numbers is done exactly on their Dyadic values, and the result is built as a finite
+    /// SurrealInf. (The real coefficients of normal forms are doubles, which could round the result, and
+    /// generating the terms of a sum or a product of finite numbers takes exponential time.)
+    ///
+    /// \param value: computes the exact result
+    /// \param out: receives the result
+    /// \return false if the result does not fit a Dyadic, or is born too late to be built; the normal form of
+    /// the result is used then
+    static bool ExactReal(std::function<Dyadic()> const &value, SurrealInf &out) {
+        try {
+            Dyadic exact = value();
+            if (exact.Birthday() > SurrealInf::MaxFiniteBirthday) { return false; }
+            out = SurrealInf(exact);
+            return true;
+        } catch (std::overflow_error const &) {
+            return false;
+        }
+    }
+
+    /// A sequence of terms making up part of one side of an arithmetic result.
+    struct TermSequence {
+        std::function<SurrealInf(int)> term; /// returns the Nth term of the sequence
+        int size; /// amount of terms, -1 for infinite
+    };
+
+    /// Merge several sequences into one side.
+    /// The terms are taken round-robin: the first term of every sequence, then the second term of every sequence,
+    /// and so on, skipping sequences that have run out. This keeps every term of an infinite union reachable.
+    /// The merged side is not sorted, as the terms of other sequences are not known without generating them;
+    /// the sides of a SurrealInf need not be (see surreals.h).
+    ///
+    /// \param sequences: the sequences to merge
+    /// \return the generating function and size of the merged side
+    static std::pair<std::function<SurrealInf(int)>, int> MergeSequences(std::vector<TermSequence> const &sequences) {
+        /// the size of the union: infinite if any sequence is infinite, the sum of the sizes otherwise
+        int size = 0;
+        for (TermSequence const &seq : sequences) {
+            if (seq.size < 0) {
+                size = -1;
+                break;
             }
-        } else if (leftSize < 0 && width > 0) { /// left side has infinite size
-            for (int i = 0; i < width; i++) {
-                /// If we are at "depth 0", swap the terms for their float representations.
-                /// Otherwise, recursively print the terms.
-                if (depth > 0) { tempstr += getLeft(i).Print(width, depth - 1); }
-                else { tempstr += std::to_string(getLeft(i).Float()); }
-                tempstr += " ";
+            size += seq.size;
+        }
+
+        std::function<SurrealInf(int)> merged = [sequences](int n) {
+            int round = 0;
+            while (true) {
+                /// count the sequences that still have a term in this round
+                int active = 0, activeFinite = 0;
+                for (TermSequence const &seq : sequences) {
+                    if (seq.size < 0) { active++; }
+                    else if (round < seq.size) {
+                        active++;
+                        activeFinite++;
+                    }
+                }
+                if (active == 0) {
+                    throw std::runtime_error("Requested a term past the end of a finite SurrealInf side!");
+                }
+
+                /// once only infinite sequences remain, every following round has the same shape
+                if (activeFinite == 0) {
+                    round += n / active;
+                    n %= active;
+                }
+
+                if (n < active) {
+                    /// the term is in this round: find the Nth sequence still active
+                    for (TermSequence const &seq : sequences) {
+                        if (seq.size < 0 || round < seq.size) {
+                            if (n == 0) { return seq.term(round); }
+                            n--;
+                        }
+                    }
+                }
+                n -= active;
+                round++;
+            }
+        };
+
+        return std::make_pair(merged, size);
+    }
+
+    /// Size of a set of pairs (i, j), where i and j range over sets of the given sizes (-1 for infinite)
+    static int PairCount(int sizeA, int sizeB) {
+        if (sizeA == 0 || sizeB == 0) { return 0; }
+        if (sizeA < 0 || sizeB < 0) { return -1; }
+        return sizeA * sizeB;
+    }
+
+    /// Enumerate pairs (i, j), where i and j range over sets of the given sizes (-1 for infinite).
+    /// Finite ranges are walked row by row, and two infinite ranges are walked diagonal by diagonal,
+    /// so that every pair is reached after finitely many steps.
+    ///
+    /// \param n: the index of the pair
+    /// \return the Nth pair
+    static std::pair<int, int> PairAt(int n, int sizeA, int sizeB) {
+        if (sizeB >= 0) { return std::make_pair(n / sizeB, n % sizeB); }
+        if (sizeA >= 0) { return std::make_pair(n % sizeA, n / sizeA); }
+
+        /// both ranges are infinite: invert the Cantor pairing function
+        int diagonal = (int) ((std::sqrt(8.0 * n + 1.0) - 1.0) / 2.0);
+        while ((diagonal + 1) * (diagonal + 2) / 2 <= n) { diagonal++; } /// guard against rounding
+        while (diagonal * (diagonal + 1) / 2 > n) { diagonal--; }
+        int j = n - diagonal * (diagonal + 1) / 2;
+        return std::make_pair(diagonal - j, j);
+    }
+
+    /// Negation
+    ///
+    /// \return the negated number: -x = { -xR | -xL }
+    SurrealInf SurrealInf::operator-() const {
+        /// numbers in normal form are negated symbolically, and real ones exactly if the result can be built
+        NormalForm nx;
+        if (KnownNormalForm(*this, nx)) {
+            SurrealInf exact;
+            if (nx.IsReal() && ExactReal([&nx]() { return -Dyadic::FromDouble(nx.RealPart()); }, exact)) {
+                return exact;
             }
-            tempstr += "... ";
+            return (-nx).ToSurrealInf();
         }
 
-        tempstr += "| ";
+        SurrealInf x = *this;
 
-        /// Print right side
-        if (rightSize > 0) { /// right side has finite, nonzero size.
-            for (int i = rightSize - 1; i >= 0; i--) {
-                /// If we are at "depth 0", swap the terms for their float representations.
-                /// Otherwise, recursively print the terms.
-                if (depth > 0) { tempstr += getRight(i).Print(width, depth - 1); }
-                else { tempstr += std::to_string(getRight(i).Float()); }
-                tempstr += " ";
+        std::function<SurrealInf(int)> tempLeft = [x](int n) mutable { return -x.getRight(n); };
+        std::function<SurrealInf(int)> tempRight = [x](int n) mutable { return -x.getLeft(n); };
+
+        return SurrealInf(tempLeft, tempRight, std::make_pair(x.rightSize, x.leftSize));
+    }
+
+    /// Addition
+    ///
+    /// \param a: an operand
+    /// \param b: an operand
+    /// \return the lazily evaluated sum
+    SurrealInf operator+(SurrealInf const &a, SurrealInf const &b) {
+        /// numbers in normal form are added symbolically, and real ones exactly if the result can be built
+        NormalForm na, nb;
+        if (KnownNormalForm(a, na) && KnownNormalForm(b, nb)) {
+            SurrealInf exact;
+            if (na.IsReal() && nb.IsReal() && ExactReal([&na, &nb]() {
+                return Dyadic::FromDouble(na.RealPart()) + Dyadic::FromDouble(nb.RealPart());
+            }, exact)) { return exact; }
+            return (na + nb).ToSurrealInf();
+        }
+
+        /// a + b = { Al + b, a + Bl | Ar + b, a + Br }
+        SurrealInf x = a, y = b;
+
+        std::vector<TermSequence> tempL = {
+                {[x, y](int n) mutable { return x.getLeft(n) + y; }, x.leftSize},
+                {[x, y](int n) mutable { return x + y.getLeft(n); }, y.leftSize}};
+        std::vector<TermSequence> tempR = {
+                {[x, y](int n) mutable { return x.getRight(n) + y; }, x.rightSize},
+                {[x, y](int n) mutable { return x + y.getRight(n); }, y.rightSize}};
+
+        auto sideL = MergeSequences(tempL);
+        auto sideR = MergeSequences(tempR);
+        return SurrealInf(sideL.first, sideR.first, std::make_pair(sideL.second, sideR.second));
+    }
+
+    /// Subtraction
+    ///
+    /// \param a: an operand
+    /// \param b: an operand
+    /// \return the lazily evaluated difference
+    SurrealInf operator-(SurrealInf const &a, SurrealInf const &b) {
+        /// Implemented using addition and negation
+        return a + (-b);
+    }
+
+    /// One family of options of a product: x1*y + x*y1 - x1*y1, where x1 ranges over
+    /// one side of x and y1 ranges over one side of y.
+    ///
+    /// \param xLeft: whether x1 is taken from the left or the right side of x
+    /// \param yLeft: whether y1 is taken from the left or the right side of y
+    /// \return the sequence of options
+    static TermSequence ProductOptions(SurrealInf const &x, SurrealInf const &y, bool xLeft, bool yLeft) {
+        int sizeX = xLeft ? x.leftSize : x.rightSize;
+        int sizeY = yLeft ? y.leftSize : y.rightSize;
+
+        SurrealInf xc = x, yc = y;
+        std::function<SurrealInf(int)> term = [xc, yc, xLeft, yLeft, sizeX, sizeY](int n) mutable {
+            std::pair<int, int> ij = PairAt(n, sizeX, sizeY);
+            SurrealInf x1 = xLeft ? xc.getLeft(ij.first) : xc.getRight(ij.first);
+            SurrealInf y1 = yLeft ? yc.getLeft(ij.second) : yc.getRight(ij.second);
+            return x1 * yc + xc * y1 - x1 * y1;
+        };
+
+        return TermSequence{term, PairCount(sizeX, sizeY)};
+    }
+
+    /// Multiplication
+    ///
+    /// \param a: an operand
+    /// \param b: an operand
+    /// \return the lazily evaluated product
+    SurrealInf operator*(SurrealInf const &a, SurrealInf const &b) {
+        /// numbers in normal form are multiplied symbolically, and real ones exactly if the result can be built
+        NormalForm na, nb;
+        if (KnownNormalForm(a, na) && KnownNormalForm(b, nb)) {
+            SurrealInf exact;
+            if (na.IsReal() && nb.IsReal() && ExactReal([&na, &nb]() {
+                return Dyadic::FromDouble(na.RealPart()) * Dyadic::FromDouble(nb.RealPart());
+            }, exact)) { return exact; }
+            return (na * nb).ToSurrealInf();
+        }
+
+        /// a*b = { Al*b + a*Bl - Al*Bl, Ar*b + a*Br - Ar*Br | Al*b + a*Br - Al*Br, Ar*b + a*Bl - Ar*Bl }
+        std::vector<TermSequence> tempL = {
+                ProductOptions(a, b, true, true),
+                ProductOptions(a, b, false, false)};
+        std::vector<TermSequence> tempR = {
+                ProductOptions(a, b, true, false),
+                ProductOptions(a, b, false, true)};
+
+        auto sideL = MergeSequences(tempL);
+        auto sideR = MergeSequences(tempR);
+        return SurrealInf(sideL.first, sideR.first, std::make_pair(sideL.second, sideR.second));
+    }
+
+    /// Ordering between "infinite" Surreals
+    ///
+    /// x <= y unless some xL >= y or some yR <= x. Proving x <= y this way requires every term of xL and yR,
+    /// which is impossible for infinite sets. But numbers also satisfy x < xR and yL < y, so finding a single
+    /// term with xR <= y or x <= yL proves x <= y as well. The comparison searches for both kinds of witness,
+    /// looking at the first `width` terms of each infinite set, and widens the search until the order
+    /// is decided or the budget runs out. When every set met along the way is finite, the search is exhaustive,
+    /// so two numbers converging to the same finite value compare Equal. Any term can be a witness, so the
+    /// search does not depend on the order the terms are generated in.
+
+    /// Three-valued result of a partial comparison
+    enum class Truth { False, True, Unknown };
+
+    /// Tracks the work done against a Budget
+    struct BudgetState {
+        long termsLeft;
+        std::chrono::steady_clock::time_point deadline;
+        bool exhausted = false; /// the budget ran out at some point
+
+        explicit BudgetState(Budget const &budget)
+                : termsLeft(budget.terms), deadline(std::chrono::steady_clock::now() + budget.time) {}
+
+        /// Account for one examined term.
+        /// \return false once the budget is exhausted
+        bool Spend() {
+            if (exhausted) { return false; }
+            if (--termsLeft < 0 || ((termsLeft & 63) == 0 && std::chrono::steady_clock::now() > deadline)) {
+                exhausted = true;
+                return false;
             }
-        } else if (rightSize < 0 && width > 0) { /// right side has infinite size
-            tempstr += "... ";
-            for (int i = width - 1; i >= 0; i--) {
-                /// If we are at "depth 0", swap the terms for their float representations.
-                /// Otherwise, recursively print the terms.
-                if (depth > 0) { tempstr += getRight(i).Print(width, depth - 1); }
-                else { tempstr += std::to_string(getRight(i).Float()); }
-                tempstr += " ";
+            return true;
+        }
+    };
+
+    /// Tracks the work done by one call to Compare
+    struct CompareState : BudgetState {
+        bool truncated = false; /// some infinite set was cut off at the search width
+
+        explicit CompareState(Budget const &budget) : BudgetState(budget) {}
+    };
+
+    /// Partial "less than or equal to" between SurrealInfs
+    ///
+    /// \param x: the left operand
+    /// \param y: the right operand
+    /// \param width: how many terms of each infinite set are examined
+    /// \param state: the shared budget
+    /// \return True or False if decided, Unknown otherwise
+    static Truth LessEqual(SurrealInf x, SurrealInf y, int width, CompareState &state) {
+        /// copies sharing the same generators are the same number
+        if (x.generators == y.generators && x.leftSize == y.leftSize && x.rightSize == y.rightSize) {
+            return Truth::True;
+        }
+
+        /// numbers in normal form are compared symbolically
+        NormalForm nx, ny;
+        if (KnownNormalForm(x, nx) && KnownNormalForm(y, ny)) {
+            return (nx <= ny) ? Truth::True : Truth::False;
+        }
+
+        /// how many terms of each set to examine
+        int xLcount = (x.leftSize < 0) ? width : x.leftSize;
+        int xRcount = (x.rightSize < 0) ? width : x.rightSize;
+        int yLcount = (y.leftSize < 0) ? width : y.leftSize;
+        int yRcount = (y.rightSize < 0) ? width : y.rightSize;
+
+        bool complete = true; /// every term that could disprove x <= y was checked and did not
+
+        /// witnesses against: xL >= y or yR <= x
+        for (int i = 0; i < std::max(xLcount, yRcount); i++) {
+            if (i < xLcount) {
+                if (!state.Spend()) { return Truth::Unknown; }
+                Truth t = LessEqual(y, x.getLeft(i), width, state);
+                if (t == Truth::True) { return Truth::False; }
+                if (t == Truth::Unknown) { complete = false; }
+            }
+            if (i < yRcount) {
+                if (!state.Spend()) { return Truth::Unknown; }
+                Truth t = LessEqual(y.getRight(i), x, width, state);
+                if (t == Truth::True) { return Truth::False; }
+                if (t == Truth::Unknown) { complete = false; }
             }
         }
 
-        tempstr += "}";
-        return tempstr;
+        if (x.leftSize < 0 || y.rightSize < 0) {
+            /// an infinite set was only partially checked
+            state.truncated = true;
+            complete = false;
+        }
+        if (complete) { return Truth::True; }
+
+        /// The search against x <= y was inconclusive, look for witnesses for it: xR <= y or x <= yL
+        for (int i = 0; i < std::max(xRcount, yLcount); i++) {
+            if (i < xRcount) {
+                if (!state.Spend()) { return Truth::Unknown; }
+                if (LessEqual(x.getRight(i), y, width, state) == Truth::True) { return Truth::True; }
+            }
+            if (i < yLcount) {
+                if (!state.Spend()) { return Truth::Unknown; }
+                if (LessEqual(x, y.getLeft(i), width, state) == Truth::True) { return Truth::True; }
+            }
+        }
+
+        return Truth::Unknown;
     }
 
+    /// Compare two SurrealInfs with a budget
+    ///
+    /// \param a: the first number
+    /// \param b: the second number
+    /// \param budget: how many terms and how much time may be spent
+    /// \return the ordering of a relative to b, or Undecided if the budget ran out
+    Ordering Compare(SurrealInf const &a, SurrealInf const &b, Budget const &budget) {
+        CompareState state(budget);
+
+        /// widen the search until the order is decided
+        for (int width = 1; !state.exhausted; width *= 2) {
+            state.truncated = false;
+            Truth le = LessEqual(a, b, width, state);
+            if (le == Truth::False) { return Ordering::Greater; }
+
+            Truth ge = LessEqual(b, a, width, state);
+            if (ge == Truth::False) { return Ordering::Less; }
+
+            if (le == Truth::True && ge == Truth::True) { return Ordering::Equal; }
+
+            /// the result is Unknown only if some infinite set got cut off or the budget ran out;
+            /// widening can not help if neither happened
+            if (!state.truncated || width > std::numeric_limits<int>::max() / 2) { break; }
+        }
+        return Ordering::Undecided;
+    }
 
-    /// The "verbose" display function for "infinite" Surreals
-    /// Displays the number using only brackets and separators
+    /// Conversion to a finite Surreal
     ///
-    /// \param width: how many terms are computed on each side
-    /// \return the string to display
-    std::string SurrealInf::PrintVerbose(int width = 5) {
-        std::string tempstr;
-        tempstr += "{ ";
+    /// The conversion is only possible if the SurrealInf has finite left and right sets, and so does every
+    /// "child" down the tree. The sizes of the sets are checked before anything is generated, so numbers with
+    /// an infinite set at the top are rejected right away. Otherwise every term of each finite side is converted
+    /// recursively: sides produced by SurrealInf arithmetic are unions of several sequences, so the greatest
+    /// term of a finite left side is not necessarily the last one. The simplifying Surreal constructor picks
+    /// the greatest from L and the smallest from R.
+    ///
+    /// The outcome, finite or not, is memoized in the shared state of the number.
+    ///
+    /// \param out: receives the converted number on success
+    /// \return false if there is an infinite set somewhere in the tree
+    bool SurrealInf::ToSurreal(Surreal &out) {
+        if (leftSize < 0 || rightSize < 0) { return false; } /// infinite sets at the top
+
+        if (!generators) {
+            out = Surreal(); /// no generating functions, { | }
+            return true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(generators->conversionMutex);
+            if (generators->finiteness == Generators::Finiteness::Finite) {
+                out = generators->finite;
+                return true;
+            }
+            if (generators->finiteness == Generators::Finiteness::Infinite) { return false; }
+        }
+
+        /// recursively convert the terms of L and R
+        std::set<Surreal> tempLset, tempRset;
+        bool isFinite = true;
+
+        /// closed-form sides are monotonic, so only their last term matters
+        bool leftClosed = generators->left.sequence.kind != Sequence::Kind::Function;
+        bool rightClosed = generators->right.sequence.kind != Sequence::Kind::Function;
+
+        for (int i = leftClosed ? leftSize - 1 : 0; i < leftSize && isFinite; i++) {
+            SurrealInf tempLinf = getLeft(i);
+            Surreal tempLfin;
+            isFinite = tempLinf.ToSurreal(tempLfin);
+            tempLset.insert(tempLfin);
+        }
+
+        for (int i = rightClosed ? rightSize - 1 : 0; i < rightSize && isFinite; i++) {
+            SurrealInf tempRinf = getRight(i);
+            Surreal tempRfin;
+            isFinite = tempRinf.ToSurreal(tempRfin);
+            tempRset.insert(tempRfin);
+        }
+
+        std::lock_guard<std::mutex> lock(generators->conversionMutex);
+        if (!isFinite) {
+            generators->finiteness = Generators::Finiteness::Infinite;
+            return false;
+        }
+
+        generators->finite = Surreal(tempLset, tempRset, true);
+        generators->finiteFloat = generators->finite.Float();
+        generators->finiteness = Generators::Finiteness::Finite;
+        out = generators->finite;
+        return true;
+    }
+
+    /// Converts the SurrealInf into a Surreal, then converts that into a float. If the conversion to
+    /// Surreal fails, returns NaN. The float is memoized along with the converted Surreal.
+    /// A number whose real value is kept as a normal form is converted from that instead, even if it is written
+    /// with infinite sets: the finite Surreal of a number with many fraction bits has a tree exponential in their
+    /// count, and a real born too late to be built finitely has no finite Surreal at all.
+    float SurrealInf::Float() {
+        if (generators && generators->normalForm && generators->normalForm->IsReal()) {
+            return (float) generators->normalForm->RealPart();
+        }
+        if (leftSize < 0 || rightSize < 0) { return NAN; } /// infinite sets at the top
+        if (!generators) { return 0; } /// { | }
+
+        Surreal temp;
+        if (!ToSurreal(temp)) { return NAN; }
+
+        std::lock_guard<std::mutex> lock(generators->conversionMutex);
+        return generators->finiteFloat;
+    }
+
+    /// Float approximation of "infinite" Surreals
+    ///
+    /// The value of { L | R } is the simplest number greater than every term of L and less than every term
+    /// of R. Terms are pulled from both sides (and approximated recursively), narrowing the interval
+    /// (lo, hi) between the greatest left term and the smallest right term seen so far, whatever order
+    /// they come in, until:
+    ///  - the interval is narrower than the precision: the number is its midpoint, up to the precision
+    ///  - a one-sided bound keeps moving by less than the precision, or stops moving: the bound has converged
+    ///  - a bound grows past 1 / precision with nothing on the other side: the number is infinite
+    ///  - the sets are exhausted, or the budget runs out
+    /// Otherwise, the simplest float in (lo, hi) is returned.
+
+    /// Recursive float approximation
+    ///
+    /// \param x: the number to approximate
+    /// \param precision: the requested tolerance
+    /// \param state: the shared budget
+    /// \param informed: set to false if the budget ran out before anything was learned about the number
+    /// \return the approximation
+    static float ApproximateNumber(SurrealInf x, float precision, BudgetState &state, bool &informed) {
+        informed = true;
+
+        /// numbers in normal form have exact answers
+        NormalForm nx;
+        if (KnownNormalForm(x, nx)) {
+            if (nx.IsInfinite()) { return (nx.Sign() > 0) ? INFINITY : -INFINITY; }
+            if (nx.IsInfinitesimal()) { return (nx.Sign() > 0) ? 0.0f : -0.0f; }
+            return (float) nx.RealPart();
+        }
 
-        if (leftSize > 0) {
-            for (int i = 0; i < leftSize; i++) {
-                tempstr += getLeft(i).PrintVerbose();
-                tempstr += " ";
+        /// finite numbers are converted exactly
+        float exact = x.Float();
+        if (!std::isnan(exact)) { return exact; }
+
+        /// a side in closed form is summed up by its bound, without pulling any terms
+        float lo = -INFINITY, hi = INFINITY;
+        double bound;
+        bool reached;
+        bool leftClosed = SideBound(x, true, bound, reached);
+        if (leftClosed) { lo = (float) bound; }
+        bool rightClosed = SideBound(x, false, bound, reached);
+        if (rightClosed) { hi = (float) bound; }
+        float limit = 1 / precision; /// bounds beyond this are considered infinite
+        float firstStep = 0, lastStep = 0; /// how far the bounds moved after the first and the latest terms
+        int stillTerms = 0; /// how many terms in a row left the bounds where they were
+        bool converged = false, infinite = false;
+
+        for (int i = 0; !converged && !infinite; i++) {
+            bool moreLeft = !leftClosed && (x.leftSize < 0 || i < x.leftSize);
+            bool moreRight = !rightClosed && (x.rightSize < 0 || i < x.rightSize);
+            if (!moreLeft && !moreRight) { break; } /// both sets exhausted
+            if (state.exhausted) { break; }
+
+            /// A term whose approximation ran out of budget before learning anything is skipped.
+            float step = 0;
+            bool termInformed;
+            if (moreLeft) {
+                if (!state.Spend()) { break; }
+                float term = ApproximateNumber(x.getLeft(i), precision, state, termInformed);
+                if (!termInformed) { break; }
+                if (term > lo) {
+                    if (lo != -INFINITY) { step = std::max(step, term - lo); }
+                    lo = term;
+                }
+            }
+            if (moreRight) {
+                if (!state.Spend()) { break; }
+                float term = ApproximateNumber(x.getRight(i), precision, state, termInformed);
+                if (!termInformed) { break; }
+                if (term < hi) {
+                    if (hi != INFINITY) { step = std::max(step, hi - term); }
+                    hi = term;
+                }
             }
-        } else if (leftSize < 0 && width > 0) {
-            for (int i = 0; i < width; i++) {
-                tempstr += getLeft(i).PrintVerbose();
-                tempstr += " ";
+            if (i == 1) { firstStep = step; }
+            lastStep = step;
+            stillTerms = (step == 0) ? stillTerms + 1 : 0;
+
+            /// The terms of a side need not be in order: a side interleaving several sequences, like the sides
+            /// of a sum, leaves the bounds still while the terms of a sequence below them are pulled. So a bound
+            /// that moves by less than the precision has converged, but one that does not move at all only once
+            /// it has stood still for most of the terms pulled so far.
+            bool settled = (step > 0) ? step < precision : (stillTerms >= 2 && stillTerms > i / 2);
+
+            if (hi - lo <= precision) { converged = true; }
+            else if ((lo >= limit && hi == INFINITY) || (hi <= -limit && lo == -INFINITY)) { infinite = true; }
+            else if (i > 0 && settled && (x.leftSize < 0 || x.rightSize < 0)) {
+                /// the bounds have stopped moving, although there are more terms
+                converged = true;
             }
-            tempstr += "... ";
         }
 
-        tempstr += "| ";
+        if (state.exhausted && !converged && lastStep > 0 && lastStep >= firstStep) {
+            /// The budget ran out while a one-sided bound was still moving by steps that do not shrink.
+            /// Such a bound does not converge, so the number lies beyond every finite value on that side.
+            if (hi == INFINITY && lo != -INFINITY) { infinite = true; }
+            if (lo == -INFINITY && hi != INFINITY) { infinite = true; }
+        }
+
+        if (infinite) { return (lo == -INFINITY) ? -INFINITY : INFINITY; }
 
-        if (rightSize > 0) {
-            for (int i = rightSize - 1; i >= 0; i--) {
-                tempstr += getRight(i).PrintVerbose();
-                tempstr += " ";
+        if (lo == -INFINITY && hi == INFINITY && (x.leftSize != 0 || x.rightSize != 0)) {
+            informed = false; /// not a single term was approximated
+            return 0;
+        }
+
+        if (hi - lo <= precision) {
+            /// pinned down within the precision. A number pinned down to zero keeps the sign of its bounds:
+            /// lo >= 0 means it is a positive infinitesimal (or a tiny positive real), and hi <= 0 a negative one.
+            float mid = (lo + hi) / 2;
+            if (std::fabs(mid) <= precision) {
+                if (lo >= 0 && !std::signbit(lo)) { return 0.0f; }
+                if (hi <= 0) { return -0.0f; }
             }
-        } else if (rightSize < 0 && width > 0) {
-            tempstr += "... ";
-            for (int i = width - 1; i >= 0; i--) {
-                tempstr += getRight(i).PrintVerbose();
-                tempstr += " ";
+            return mid;
+        }
+        return (float) SimplestBetween(lo, hi);
+    }
+
+    /// Float approximation of a SurrealInf
+    ///
+    /// \param precision: the tolerance of the approximation
+    /// \param budget: how many terms and how much time may be spent
+    /// \return the approximation: a float, +/- infinity for infinite numbers or +/- zero for infinitesimals
+    float SurrealInf::Approximate(float precision, Budget const &budget) {
+        BudgetState state(budget);
+        bool informed;
+        return ApproximateNumber(*this, precision, state, informed);
+    }
+
+    /// Walk a SurrealInf for display, like WriteSurreal. Infinite sides show their first `width` terms followed by
+    /// "...", and terms are fetched (and generated, if needed) as the walk reaches them.
+    ///
+    /// In verbose mode, every term is written in full with 5 terms per infinite side, whatever the width of the
+    /// top level. In hybrid mode, terms below `depth` are written as floats, and sides in closed form are
+    /// written from their formula at that level.
+    static void WriteSurrealInf(SurrealInf const &number, PrintBuffer &out, int width, int depth, bool verbose) {
+        struct Frame {
+            SurrealInf node;
+            int count[2]; /// how many terms are written on each side
+            bool closed[2]; /// whether each side is written from its formula
+            int side; /// 0 while writing the left side, 1 for the right side
+            int next; /// how many terms of the current side have been written
+            int width;
+            int depth;
+        };
+
+        /// Start writing a node: "{ ", then its left side
+        auto open = [&out, verbose](SurrealInf const &node, int nodeWidth, int nodeDepth) {
+            Frame frame;
+            frame.node = node;
+            frame.count[0] = (node.leftSize >= 0) ? node.leftSize : std::max(nodeWidth, 0);
+            frame.count[1] = (node.rightSize >= 0) ? node.rightSize : std::max(nodeWidth, 0);
+            for (int i = 0; i < 2; i++) {
+                SurrealInf::Side *side = SideOf(node.generators, i == 0);
+                frame.closed[i] = !verbose && nodeDepth <= 0 && side &&
+                                  side->sequence.kind != SurrealInf::Sequence::Kind::Function;
+            }
+            frame.side = 0;
+            frame.next = 0;
+            frame.width = nodeWidth;
+            frame.depth = nodeDepth;
+            out.Put("{ ");
+            return frame;
+        };
+
+        std::vector<Frame> stack;
+        stack.push_back(open(number, width, depth));
+
+        while (!stack.empty()) {
+            Frame &top = stack.back();
+            bool infinite = ((top.side == 0) ? top.node.leftSize : top.node.rightSize) < 0;
+
+            if (top.next == top.count[top.side]) {
+                if (top.side == 0) {
+                    /// done with the left side
+                    if (infinite && top.width > 0) { out.Put("... "); } /// left side has infinite size
+                    out.Put("| ");
+                    top.side = 1;
+                    top.next = 0;
+                    bool rightInfinite = top.node.rightSize < 0;
+                    if (rightInfinite && top.width > 0) { out.Put("... "); } /// right side has infinite size
+                } else {
+                    /// done with the node, which is a term of the node below it on the stack (if any)
+                    out.Put("}");
+                    stack.pop_back();
+                    if (!stack.empty()) { out.Put(" "); }
+                }
+                continue;
+            }
+
+            /// the terms are written in the order they are generated, the right side mirrored so that the terms
+            /// not written stand next to the bar (sides in order come out ascending from left to right)
+            int index = (top.side == 0) ? top.next : top.count[1] - 1 - top.next;
+            top.next++;
+            SurrealInf::Side *side = SideOf(top.node.generators, top.side == 0);
+
+            /// If we are at "depth 0", swap the terms for their float representations.
+            /// Otherwise, descend into the terms.
+            if (top.closed[top.side]) {
+                out.Put(std::to_string((float) side->sequence.Term(index)));
+                out.Put(" ");
+                continue;
+            }
+            SurrealInf term = FetchTerm(side, index);
+            if (verbose) {
+                stack.push_back(open(term, 5, 0));
+            } else if (top.depth > 0) {
+                int termWidth = top.width, termDepth = top.depth - 1;
+                stack.push_back(open(term, termWidth, termDepth));
+            } else {
+                out.Put(std::to_string(term.Float()));
+                out.Put(" ");
             }
         }
+    }
 
-        tempstr += "}";
+    /// Hybrid display for SurrealInf
+    /// Prints the number using brackets and separators, shortening the children to floats after a set depth.
+    ///
+    /// \param width: how many terms are computed in infinite sets
+    /// \param depth: at which level the numbers are shortened to floats
+    /// \return the string to display
+    std::string SurrealInf::Print(int width = 5, int depth = 0) {
+        std::string tempstr;
+        Print(StringSink(tempstr), width, depth);
+        return tempstr;
+    }
+
+    /// The "verbose" display function for "infinite" Surreals
+    /// Displays the number using only brackets and separators
+    ///
+    /// \param width: how many terms are computed on each side
+    /// \return the string to display
+    std::string SurrealInf::PrintVerbose(int width = 5) {
+        std::string tempstr;
+        PrintVerbose(StringSink(tempstr), width);
         return tempstr;
     }
 
+    /// Streaming hybrid display
+    ///
+    /// \param sink: receives the text
+    /// \param width: how many terms are computed in infinite sets
+    /// \param depth: at which level the numbers are shortened to floats
+    void SurrealInf::Print(PrintSink const &sink, int width, int depth) {
+        PrintBuffer out(sink);
+        WriteSurrealInf(*this, out, width, depth, false);
+        out.Flush();
+    }
+
+    void SurrealInf::Print(std::ostream &os, int width, int depth) {
+        Print(StreamSink(os), width, depth);
+    }
+
+    /// Streaming verbose display
+    ///
+    /// \param sink: receives the text
+    /// \param width: how many terms are computed on each side
+    void SurrealInf::PrintVerbose(PrintSink const &sink, int width) {
+        PrintBuffer out(sink);
+        WriteSurrealInf(*this, out, width, 0, true);
+        out.Flush();
+    }
+
+    void SurrealInf::PrintVerbose(std::ostream &os, int width) {
+        PrintVerbose(StreamSink(os), width);
+    }
+
 } //surreals
 
-/// ostream display uses the Print method
+/// ostream display streams the Print method straight into the ostream
 std::ostream &operator<<(std::ostream &os, surreals::Surreal const &number) {
-    os << number.Print(0);
+    number.Print(os, 0);
     return os;
 }
 
 std::ostream &operator<<(std::ostream &os, surreals::SurrealInf &number) {
-    os << number.Print(5, 0);
+    number.Print(os, 5, 0);
     return os;
 }
\ No newline at end of file
@@ -5,27 +5,64 @@
 ///         Has comparison and ordering, arithmetic, conversion to and from int and float, verbose and short display.
 ///
 ///     SurrealInf - a class representing surreal numbers with possibility for infinite sets.
-///         Currently only has constructions and display.
+///         Has construction, lazy arithmetic and display.
 ///
 
 #ifndef SURREALS_SURREALS_H
 #define SURREALS_SURREALS_H
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace surreals {
 
     /// forward declarations
     class Surreal; /// the Surreal class
     class SurrealInf; /// the "infinite" Surreal class
+    class NormalForm; /// Conway normal form, see normalform.h
+    class Dyadic; /// exact dyadic rationals, see dyadic.h
+    class MemoFile; /// read-only lookup table file, see memofile.h
+    class SmallTable; /// dense tables for numbers of small birthday, see smalltable.h
+
+    /// Destination of the streaming printers: receives the text in chunks, in order.
+    /// The printers buffer a few kilobytes at most, so a sink sees the text while it is being produced.
+    using PrintSink = std::function<void(char const *text, std::size_t length)>;
+
+    /// Memory held by a number or a lookup table, as estimated by the MemoryUsage queries.
+    /// Bytes cover the objects and the nodes of the std::set, std::map and std::vector holding them, but not the
+    /// allocator's own overhead, nor the captures of generating functions.
+    ///
+    /// Nodes are split into unique and shared ones (nodes = uniqueNodes + sharedNodes, and the same for bytes):
+    /// a Surreal holds its terms by value, so its shared nodes are copies of structure met earlier in the same
+    /// query, the memory that storing equal subtrees once would save. The term caches of SurrealInfs are held by
+    /// reference instead, so there the shared nodes are the generator states also held elsewhere (by copies of a
+    /// number, or by generating functions), the memory that releasing the number might not free.
+    struct Footprint {
+        std::size_t nodes = 0; /// Surreal nodes, and the generator states of SurrealInfs
+        std::size_t bytes = 0;
+        std::size_t uniqueNodes = 0;
+        std::size_t uniqueBytes = 0;
+        std::size_t sharedNodes = 0;
+        std::size_t sharedBytes = 0;
+
+        Footprint &operator+=(Footprint const &other);
+
+        /// One "name value" pair per line
+        std::string ToString() const;
+    };
 
     /// A class representing surreal numbers with finite left and right sets.
     class Surreal {
@@ -42,6 +79,14 @@ namespace surreals {
         static std::map<std::pair<Surreal, Surreal>, Surreal> AddLookup;
         static std::map<std::pair<Surreal, Surreal>, Surreal> MultLookup;
 
+        /// Optional read-only base layer under both tables, mapped from a file written by MemoFile::Dump.
+        /// It is consulted when the in-memory tables miss; the results found there are copied into them.
+        static std::shared_ptr<MemoFile> LookupBase;
+
+        /// Optional dense tables for numbers of small birthday, installed by SmallTable::Install.
+        /// They are consulted before the lookup tables, and their results are not copied into them.
+        static std::shared_ptr<SmallTable> LookupSmall;
+
         /// Constructors
         Surreal(std::set<Surreal> const &leftIn,
                 std::set<Surreal> const &rightIn,
@@ -65,6 +110,15 @@ namespace surreals {
         /// Depth of the number
         std::size_t Depth() const;
 
+        /// Memory held by the number, with the repeated subtrees as shared
+        Footprint MemoryUsage() const;
+
+        /// Memory held by a lookup table, with the subtrees repeated across its entries as shared
+        static Footprint LookupMemoryUsage(std::map<std::pair<Surreal, Surreal>, Surreal> const &table);
+
+        /// Memory held by AddLookup and MultLookup together. Neither may be modified meanwhile.
+        static Footprint LookupMemoryUsage();
+
         /// In-place Arithmetic
 
         Surreal &operator+=(Surreal const &other);
@@ -87,6 +141,42 @@ namespace surreals {
         /// hybrid display
         std::string Print(int depth) const;
 
+        /// Streaming display, written as it is produced to a sink, an std::ostream or an output iterator.
+        /// The tree is walked without recursion, keeping one frame per level.
+        void PrintVerbose(PrintSink const &sink) const;
+
+        void PrintVerbose(std::ostream &os) const;
+
+        void Print(PrintSink const &sink, int depth) const;
+
+        void Print(std::ostream &os, int depth) const;
+
+        /// Compact display: every distinct node is written once, on a line of its own, as "@k = { @i @j | @m }",
+        /// where @i, @j, @m name nodes written before it. A last line "@k" names the number itself.
+        /// The output grows with the amount of distinct nodes, rather than with the size of the tree.
+        /// The node names are those of a single call, and SurrealParser reads the text back.
+        std::string PrintDag() const;
+
+        void PrintDag(PrintSink const &sink) const;
+
+        void PrintDag(std::ostream &os) const;
+
+        template<class OutputIt>
+        OutputIt PrintVerboseTo(OutputIt out) const {
+            PrintVerbose(PrintSink([&out](char const *text, std::size_t length) {
+                out = std::copy(text, text + length, out);
+            }));
+            return out;
+        }
+
+        template<class OutputIt>
+        OutputIt PrintTo(OutputIt out, int depth) const {
+            Print(PrintSink([&out](char const *text, std::size_t length) {
+                out = std::copy(text, text + length, out);
+            }), depth);
+            return out;
+        }
+
     };
 
     /// Arithmetic between Surreals
@@ -127,6 +217,13 @@ namespace surreals {
 
     bool operator<(surreals::Surreal const &a, surreals::Surreal const &b);
 
+    /// Limits on the amount of work done by operations on SurrealInf that evaluate generator terms
+    /// incrementally (Compare and Approximate). Both limits apply, whichever runs out first.
+    struct Budget {
+        long terms = 10000; /// how many generated terms may be examined in total
+        std::chrono::milliseconds time = std::chrono::milliseconds(100); /// wall-clock limit
+    };
+
     /// A class representing surreal numbers with support for "infinite" sets.
     class SurrealInf {
     public:
@@ -138,11 +235,116 @@ namespace surreals {
         /// are greater than any generated in the left.
         /// In order for the arithmetic operations to work, it is trusted that:
         ///
-        /// 1) the left function accepts all non-negative integers and generates numbers in non-strict ASCENDING order
-        /// 2) the right function accepts all non-negative integers and generates numbers in non-strict DESCENDING order
-        /// 3) any number generated by the right function is greater than any number generated by the left function
-        std::function<SurrealInf(int)> left;
-        std::function<SurrealInf(int)> right;
+        /// 1) each function accepts every index below the size of its side (all non-negative integers if infinite)
+        /// 2) any number generated by the right function is greater than any number generated by the left function
+        ///
+        /// The terms of a side may come in any order. The sides of arithmetic results interleave several sequences,
+        /// so their terms are not sorted, and nothing that reads a generating function relies on it: conversion
+        /// looks at every term of a finite side, and comparison and approximation keep the greatest left and the
+        /// smallest right term they have seen. Only closed-form Sequences (below) are monotonic.
+        ///
+        /// When evaluating the generating functions, SurrealInf caches the generated numbers for each side.
+        /// Since the generators are indexed 0, 1, 2, ..., each cache is an std::vector of slots: the Nth slot
+        /// holds the Nth generated number, or nothing if that term has not been generated (or has been evicted).
+        ///
+        /// Every cached term is a SurrealInf with caches of its own, so the caches can be capped: per side of
+        /// a number (SetCacheLimit), and across all numbers (SetGlobalCacheLimit). Once over a limit, the least
+        /// recently used terms are evicted, and are generated again if they are fetched later on.
+        ///
+        /// The cache is guarded by a mutex, so terms can be fetched from several threads at once.
+        /// The generator itself is called without holding the mutex: it may be called concurrently
+        /// for different indices, and must be safe to use that way when terms are fetched in parallel.
+        ///
+        /// Instead of an arbitrary function, a side can be described by a closed-form Sequence of real numbers.
+        /// Its terms are known without calling anything, along with the bound and the limit of the sequence,
+        /// so comparison, conversion and display can skip generating such a side. The generating function of
+        /// the side is still provided, and returns the terms as SurrealInfs when they are actually needed.
+        struct Sequence {
+            /// Function: an arbitrary generating function, nothing is known about it
+            /// Constant: a
+            /// Linear: a + b * n
+            /// Geometric: a + b * 2^-n
+            enum class Kind { Function, Constant, Linear, Geometric };
+
+            Kind kind = Kind::Function;
+            double a = 0;
+            double b = 0;
+
+            static Sequence Constant(double value);
+
+            static Sequence Linear(double start, double step);
+
+            static Sequence Geometric(double limit, double scale);
+
+            /// the Nth term, in O(1)
+            double Term(int n) const;
+
+            /// the limit of the sequence, +/- infinity if it diverges
+            double Limit() const;
+
+            /// whether the limit is reached by some term (it is for a constant sequence)
+            bool LimitReached() const;
+
+            /// non-strict monotonicity, as required for the left and the right sides
+            bool Ascending() const;
+
+            bool Descending() const;
+        };
+
+        struct Side {
+            std::function<SurrealInf(int)> generator;
+            Sequence sequence; /// the closed form of the generator, if known
+            std::vector<SurrealInf> cache;
+            std::vector<unsigned long long> lastUse; /// when each slot was last fetched, 0 for an empty slot
+            std::size_t cached = 0; /// how many slots hold a term
+
+            /// The cached slots from the least to the most recently used, as a list linked through the slot
+            /// indices, so the term to evict is found without a scan. NoSlot ends the list.
+            static const std::size_t NoSlot = (std::size_t) -1;
+            std::vector<std::size_t> olderUse; /// the slot fetched before each cached slot
+            std::vector<std::size_t> newerUse; /// the slot fetched after each cached slot
+            std::size_t leastRecent = NoSlot;
+            std::size_t mostRecent = NoSlot;
+
+            std::size_t limit = 0; /// the most terms cached, 0 for no limit
+            std::mutex mutex;
+        };
+
+        /// The generating functions and their caches are held in a reference-counted state shared
+        /// by every copy of the SurrealInf. Copying a SurrealInf (or returning one of its terms by value)
+        /// never duplicates the caches, and a term generated through one copy is seen by all the others.
+        struct Generators {
+            Side left;
+            Side right;
+
+            /// If the value of the number is known in Conway normal form (numbers created from an int, a float
+            /// or a NormalForm, and arithmetic results on those), it is kept here. Arithmetic and comparison
+            /// then work on the normal forms instead of evaluating the generating functions.
+            std::shared_ptr<const NormalForm> normalForm;
+
+            /// The result of converting the number into a finite Surreal is memoized, so that the conversion
+            /// (and Float, which display calls for every printed term) is done at most once per number.
+            enum class Finiteness { Unknown, Finite, Infinite };
+            Finiteness finiteness = Finiteness::Unknown;
+            Surreal finite; /// the converted number, if finiteness == Finite
+            float finiteFloat = 0; /// finite.Float(), if finiteness == Finite
+            std::mutex conversionMutex;
+
+            /// Every Generators is registered for the global cache limit and occupancy reports
+            Generators();
+
+            ~Generators();
+        };
+
+        /// Occupancy of the term caches of all SurrealInfs
+        struct CacheOccupancy {
+            std::size_t objects = 0; /// numbers with generating functions
+            std::size_t terms = 0; /// terms cached across all numbers
+            std::size_t limit = 0; /// the global limit, 0 for none
+            unsigned long long evictions = 0; /// terms evicted so far
+        };
+
+        std::shared_ptr<Generators> generators;
 
         /// Rather than having an infinite number of terms, one side of SurrealInf might have no terms or
         /// a finite number of terms (for example, Omega has the form { 1, 2, 3, 4, 5, ... | }, and has no terms in R).
@@ -153,22 +355,27 @@ namespace surreals {
         int leftSize = 0;
         int rightSize = 0;
 
-        /// When evaluating the generating functions, SurrealInf caches the generated numbers for each side
-        /// in std::map, with keys being the integers and values being the generated numbers.
-        std::map<int, SurrealInf> leftCache;
-        std::map<int, SurrealInf> rightCache;
-
         /// Constructors
         SurrealInf(std::function<SurrealInf(int)> const &leftIn,
                    std::function<SurrealInf(int)> const &rightIn,
                    std::pair<int, int> const &sizes);
 
+        SurrealInf(Sequence const &leftIn, Sequence const &rightIn, std::pair<int, int> const &sizes);
+
         explicit SurrealInf(Surreal const &inputSur);
 
         explicit SurrealInf(float const &inputFloat);
 
         explicit SurrealInf(int const &inputInt);
 
+        /// An exact real number, built along its sign expansion: every number on the way holds the one before it
+        /// as its only term, so the chain is linear in the birthday. Keep the birthday to MaxFiniteBirthday or so,
+        /// as converting the number walks the whole chain recursively.
+        explicit SurrealInf(Dyadic const &value);
+
+        /// Real results born after this day are not built as finite numbers by arithmetic or NormalForm
+        static const int MaxFiniteBirthday = 1024;
+
         SurrealInf();
 
         /// Destructor
@@ -177,19 +384,105 @@ namespace surreals {
         /// Fetch the Nth element from the left set
         SurrealInf getLeft(int const &n);
 
-        /// Fetch the Nth-to-last element from the right set
+        /// Fetch the Nth element from the right set
         SurrealInf getRight(int const &n);
 
-        /// Float conversion
+        /// Generate and cache the next K terms of the left set
+        void PrefetchLeft(int const &k);
+
+        /// Generate and cache the next K terms of the right set
+        void PrefetchRight(int const &k);
+
+        /// Generate and cache every term displayed by Print(width, depth), evaluating generators on several threads
+        void Prefetch(int width, int depth, unsigned threads);
+
+        /// Limit how many terms are cached on each side of this number, 0 for no limit
+        void SetCacheLimit(std::size_t terms);
+
+        /// How many terms are cached on both sides of this number
+        std::size_t CachedTerms() const;
+
+        /// Limit how many terms are cached on each side of numbers created from now on, 0 for no limit
+        static void SetDefaultCacheLimit(std::size_t terms);
+
+        /// Limit how many terms are cached across all numbers, 0 for no limit
+        static void SetGlobalCacheLimit(std::size_t terms);
+
+        /// Report how many numbers and terms are cached
+        static CacheOccupancy GlobalCacheOccupancy();
+
+        /// Memory held by the number and every term cached below it, each generator state counted once
+        Footprint MemoryUsage() const;
+
+        /// unary minus (negation)
+        SurrealInf operator-() const;
+
+        /// Conversion to a finite Surreal, without exceptions.
+        /// Returns false if the number has infinite sets somewhere in its tree.
+        bool ToSurreal(Surreal &out);
+
+        /// Float conversion. Returns NaN if there is an infinite set anywhere in the tree,
+        /// unless the number is known to be real.
         float Float();
 
+        /// Float approximation, pulling generator terms until the number is pinned down within `precision`
+        /// or the budget runs out. Infinite numbers map to +/- infinity, infinitesimals to +/- zero.
+        float Approximate(float precision, Budget const &budget = Budget());
+
         /// Print verbose display
         std::string PrintVerbose(int width);
 
         /// Print "hybrid" display
         std::string Print(int width, int depth);
 
+        /// Print "hybrid" display, generating the displayed terms on a pool of threads first
+        std::string Print(int width, int depth, unsigned threads);
+
+        /// Streaming display, written as it is produced to a sink, an std::ostream or an output iterator.
+        /// The terms are fetched one at a time while printing, without recursion.
+        void PrintVerbose(PrintSink const &sink, int width);
+
+        void PrintVerbose(std::ostream &os, int width);
+
+        void Print(PrintSink const &sink, int width, int depth);
+
+        void Print(std::ostream &os, int width, int depth);
+
+        template<class OutputIt>
+        OutputIt PrintVerboseTo(OutputIt out, int width) {
+            PrintVerbose(PrintSink([&out](char const *text, std::size_t length) {
+                out = std::copy(text, text + length, out);
+            }), width);
+            return out;
+        }
+
+        template<class OutputIt>
+        OutputIt PrintTo(OutputIt out, int width, int depth) {
+            Print(PrintSink([&out](char const *text, std::size_t length) {
+                out = std::copy(text, text + length, out);
+            }), width, depth);
+            return out;
+        }
+
     };
+
+    /// Lazy arithmetic between SurrealInfs.
+    /// The result's generating functions are derived from the operands' generating functions,
+    /// so no terms are evaluated until they are requested.
+    SurrealInf operator+(SurrealInf const &a, SurrealInf const &b);
+
+    SurrealInf operator-(SurrealInf const &a, SurrealInf const &b);
+
+    SurrealInf operator*(SurrealInf const &a, SurrealInf const &b);
+
+    /// Ordering between SurrealInfs
+    ///
+    /// The order of two "infinite" numbers can not always be decided by looking at finitely many terms,
+    /// so the comparison is given a budget, and reports Undecided once the budget runs out.
+    enum class Ordering { Less, Equal, Greater, Undecided };
+
+    /// Compare two SurrealInfs, evaluating generator terms incrementally until the order is decided
+    Ordering Compare(SurrealInf const &a, SurrealInf const &b, Budget const &budget = Budget());
 } // surreals
 
 /// iostream display
@@ -0,0 +1,56 @@
+#include "../surreals.h"
+#include "../parse.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace surreals;
+
+static int failures = 0;
+
+static void Check(bool condition, std::string const &what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+/// Whether the parser rejects a text as malformed
+static bool Rejects(std::string const &text) {
+    try {
+        SurrealParser().Parse(text);
+    } catch (std::runtime_error const &) {
+        return true;
+    }
+    return false;
+}
+
+/// Float terms within the bounds are converted exactly
+void FloatTerms() {
+    SurrealParser parser;
+    Check(parser.Parse("{ 0.500000 | 1.000000 }").Float() == 0.75f, "{ 0.5 | 1 } is 0.75");
+    Check(parser.Parse("{ -1024 | }").Float() == -1023, "{ -1024 | } is -1023");
+    Check(parser.Parse("{ 0.100000 | }").left.begin()->Float() == 0.1f, "the term 0.1 is 0.1f");
+}
+
+/// Float terms the Surreal float constructor can not build exactly, or not quickly, are malformed
+void FloatTermBounds() {
+    Check(Rejects("{ 1e30 | }"), "1e30 is too large");
+    Check(Rejects("{ | -3000000000 }"), "-3000000000 is too large");
+    Check(Rejects("{ 1024.5 | }"), "1024.5 is too large");
+    Check(Rejects("{ 1e-30 | }"), "1e-30 is too precise");
+    Check(Rejects("{ 0x1p-33 | }"), "2^-33 is too precise");
+    Check(!Rejects("{ 0x1p-32 | }"), "2^-32 is accepted");
+}
+
+int main() {
+    FloatTerms();
+    FloatTermBounds();
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "../surreals.h"
+#include "../normalform.h"
+#include "../dyadic.h"
+#include <iostream>
+#include <set>
+#include <string>
+
+using namespace surreals;
+
+static int failures = 0;
+
+static void Check(bool condition, std::string const &what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+/// Whether every set down the tree is finite. Shared terms are visited once, so unlike ToSurreal this
+/// takes no longer for numbers with many fraction bits.
+static bool IsFinite(SurrealInf number, std::set<SurrealInf::Generators const *> &seen) {
+    if (number.leftSize < 0 || number.rightSize < 0) { return false; }
+    if (!number.generators || !seen.insert(number.generators.get()).second) { return true; }
+    for (int i = 0; i < number.leftSize; i++) {
+        if (!IsFinite(number.getLeft(i), seen)) { return false; }
+    }
+    for (int i = 0; i < number.rightSize; i++) {
+        if (!IsFinite(number.getRight(i), seen)) { return false; }
+    }
+    return true;
+}
+
+/// Whether a number is finite and has the exact value
+static bool IsExactly(SurrealInf number, Dyadic const &value) {
+    std::set<SurrealInf::Generators const *> seen;
+    NormalForm form;
+    return IsFinite(number, seen) && NormalForm::FromSurrealInf(number, form) && form == NormalForm(value.Double());
+}
+
+/// Reals above 64, and sums of floats that no float holds, stay finite and exact
+void RealArithmetic() {
+    SurrealInf sum = SurrealInf(40) + SurrealInf(30);
+    Surreal finite;
+    Check(sum.Float() == 70, "40 + 30 converts to 70");
+    Check(sum.ToSurreal(finite) && Dyadic::FromSurreal(finite) == Dyadic(70), "40 + 30 is the finite number 70");
+
+    SurrealInf product = SurrealInf(9) * SurrealInf(-8);
+    Check(product.Float() == -72, "9 * -8 converts to -72");
+    Check(IsExactly(product, Dyadic(-72)), "9 * -8 is the finite number -72");
+
+    SurrealInf fractions = SurrealInf(0.1f) + SurrealInf(0.2f);
+    Dyadic exact = Dyadic::FromDouble(0.1f) + Dyadic::FromDouble(0.2f);
+    Check(fractions.Float() == (float) exact.Double(), "0.1f + 0.2f converts to its exact sum");
+    Check(IsExactly(fractions, exact), "0.1f + 0.2f is finite and exact");
+
+    Check(IsExactly(-SurrealInf(70.5f), Dyadic(-141, 1)), "-(70.5) is the finite number -70.5");
+
+    /// born too late to be built finitely, but still known exactly
+    SurrealInf large = SurrealInf(1200) + SurrealInf(30);
+    NormalForm form;
+    Check(large.Float() == 1230, "1200 + 30 converts to 1230");
+    Check(NormalForm::FromSurrealInf(large, form) && form == NormalForm(1230.0), "1200 + 30 is known as 1230");
+}
+
+/// Normal forms convert to and from SurrealInfs without losing precision
+void NormalFormConversion() {
+    Check(IsExactly(NormalForm(70.0).ToSurrealInf(), Dyadic(70)), "the normal form 70 converts to a finite number");
+    Check(IsExactly(NormalForm(0.3).ToSurrealInf(), Dyadic::FromDouble(0.3)), "the normal form 0.3 converts exactly");
+
+    /// real results of transfinite arithmetic
+    SurrealInf omega = NormalForm::Omega().ToSurrealInf();
+    SurrealInf difference = (omega + NormalForm(0.3).ToSurrealInf()) - omega;
+    Check(difference.Float() == 0.3f, "(w + 0.3) - w converts to 0.3");
+    Check(IsExactly(difference, Dyadic::FromDouble(0.3)), "(w + 0.3) - w is finite and exact");
+
+    /// a finite number without a normal form: its exact value is recovered from the finite Surreal
+    SurrealInf untagged(Dyadic(3, 3).ToSurreal());
+    Check(untagged.generators && !untagged.generators->normalForm, "{ 1/4 | 1/2 } has no normal form up front");
+    Check(IsExactly(untagged, Dyadic(3, 3)), "{ 1/4 | 1/2 } reads back as 0.375");
+}
+
+/// The sides of a difference interleave the sides of its operands, out of order
+void InterleavedSides() {
+    SurrealInf one([](int n) { return SurrealInf(Surreal(1.0f - std::ldexp(1.0f, -n - 1))); }, nullptr,
+                   std::make_pair(-1, 0));
+    SurrealInf three([](int n) { return SurrealInf(Surreal(3.0f - std::ldexp(1.0f, -n))); }, nullptr,
+                     std::make_pair(-1, 0));
+
+    Check(one.Approximate(1e-3f) == 1, "{ 1/2, 3/4, 7/8, ... | } approximates to 1");
+    Check((three - one).Approximate(1e-3f) == 2, "3 - 1 approximates to 2, although its sides are not in order");
+}
+
+int main() {
+    RealArithmetic();
+    NormalFormConversion();
+    InterleavedSides();
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+///
+/// Implementations for the tracing of finite Surreal arithmetic.
+///
+
+#include "trace.h"
+#include "dyadic.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+namespace surreals {
+
+    namespace {
+
+        TraceSink traceSink;
+        std::atomic<bool> traceActive{false};
+        std::atomic<int> traceMaxDepth{-1};
+
+        /// Write text as a JSON string, escaping quotes and backslashes and dropping control characters
+        void WriteJsonString(std::ostream &out, char const *text) {
+            out << '"';
+            for (; *text; text++) {
+                if (*text == '"' || *text == '\\') { out << '\\' << *text; }
+                else if ((unsigned char) *text >= 0x20) { out << *text; }
+            }
+            out << '"';
+        }
+
+    }
+
+#ifdef SURREALS_TRACE
+
+    bool Trace::Enabled() {
+        return true;
+    }
+
+    thread_local int TraceScope::depth = 0;
+
+    /// Time since the first span, in microseconds
+    static double TraceClock() {
+        using Clock = std::chrono::steady_clock;
+        static const Clock::time_point epoch = Clock::now();
+        return std::chrono::duration<double, std::micro>(Clock::now() - epoch).count();
+    }
+
+    /// Numbers the threads in the order they make their first span
+    static std::uint64_t TraceThread() {
+        static std::atomic<std::uint64_t> next{0};
+        thread_local std::uint64_t id = next.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    /// The birthday of a number, or -1 if it does not fit a Dyadic
+    static long long TraceBirthday(Surreal const &number) {
+        try {
+            return (long long) Dyadic::FromSurreal(number).Birthday();
+        } catch (std::overflow_error const &) {
+            return -1;
+        }
+    }
+
+    /// The birthdays are taken before the clock starts, so they are not part of the duration
+    TraceScope::TraceScope(char const *name, Surreal const &a, Surreal const &b) {
+        int maxDepth = traceMaxDepth.load(std::memory_order_relaxed);
+        if (traceActive.load(std::memory_order_acquire) && (maxDepth < 0 || depth <= maxDepth)) {
+            active = true;
+            event.name = name;
+            event.outcome = "computed";
+            event.depth = depth;
+            event.birthdayA = TraceBirthday(a);
+            event.birthdayB = TraceBirthday(b);
+            event.thread = TraceThread();
+            event.startUs = TraceClock();
+        }
+        depth++;
+    }
+
+    TraceScope::~TraceScope() {
+        depth--;
+        if (!active) { return; }
+        event.durationUs = TraceClock() - event.startUs;
+        if (traceActive.load(std::memory_order_acquire)) { traceSink(event); }
+    }
+
+    void TraceScope::Outcome(char const *outcome) {
+        event.outcome = outcome;
+    }
+
+#else
+
+    bool Trace::Enabled() {
+        return false;
+    }
+
+#endif
+
+    void Trace::SetSink(TraceSink const &sink) {
+        traceActive.store(false);
+        traceSink = sink;
+        traceActive.store((bool) sink);
+    }
+
+    void Trace::SetMaxDepth(int depth) {
+        traceMaxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    ChromeTraceWriter::ChromeTraceWriter(std::ostream &output) : out(output) {
+        out << "{\"traceEvents\":[";
+    }
+
+    ChromeTraceWriter::~ChromeTraceWriter() {
+        Finish();
+    }
+
+    /// Times are formatted on their own, in fixed notation to the nanosecond, so the format flags of the stream
+    /// are left as the caller set them
+    void ChromeTraceWriter::Record(TraceEvent const &event) {
+        char times[96];
+        std::snprintf(times, sizeof(times), ",\"ts\":%.3f,\"dur\":%.3f", event.startUs, event.durationUs);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (finished) { return; }
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        WriteJsonString(out, event.name);
+        out << ",\"cat\":\"surreals\",\"ph\":\"X\"" << times
+            << ",\"pid\":1,\"tid\":" << event.thread << ",\"args\":{\"outcome\":";
+        WriteJsonString(out, event.outcome);
+        out << ",\"depth\":" << event.depth << ",\"birthday_a\":" << event.birthdayA
+            << ",\"birthday_b\":" << event.birthdayB << "}}";
+        first = false;
+    }
+
+    TraceSink ChromeTraceWriter::Sink() {
+        return [this](TraceEvent const &event) { Record(event); };
+    }
+
+    void ChromeTraceWriter::Finish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (finished) { return; }
+        out << "\n]}\n";
+        out.flush();
+        finished = true;
+    }
+
+}
@@ -0,0 +1,117 @@
+///
+/// Tracing of finite Surreal arithmetic.
+///
+/// When the library is configured with -DSURREALS_TRACE=ON, every call of operator+ and operator* records a span:
+/// the operation, its nesting depth on the calling thread (0 for a call made from outside the arithmetic), the
+/// birthdays of the operands, where the result came from, and when it started and how long it took. The spans go
+/// to the sink installed with Trace::SetSink, for example a ChromeTraceWriter, whose output can be opened in
+/// chrome://tracing or Perfetto to see where a slow product spends its time.
+///
+/// Without a sink nothing is recorded, and without the option the instrumentation is not compiled at all.
+/// Computing the birthdays of the operands takes time of its own, so durations are only comparable between traces.
+///
+
+#ifndef SURREALS_TRACE_H
+#define SURREALS_TRACE_H
+
+#include "surreals.h"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+
+namespace surreals {
+
+    /// A finished span
+    struct TraceEvent {
+        char const *name; /// "add" or "multiply"
+        char const *outcome; /// "small", "hit", "base" (found in a table) or "computed"
+        int depth;
+        long long birthdayA; /// -1 if too large to compute
+        long long birthdayB;
+        std::uint64_t thread; /// a small number identifying the thread
+        double startUs; /// since the first span, in microseconds
+        double durationUs;
+    };
+
+    using TraceSink = std::function<void(TraceEvent const &event)>;
+
+    class Trace {
+    public:
+        /// Whether the instrumentation is compiled in
+        static bool Enabled();
+
+        /// Install a sink, or remove it with nullptr. Spans are delivered on the thread that made them, so the sink
+        /// must be safe to call from several threads if the arithmetic runs on several. The sink should be
+        /// installed and removed while no arithmetic is running.
+        static void SetSink(TraceSink const &sink);
+
+        /// Record only spans nested at most this deep (-1, the default, for all of them)
+        static void SetMaxDepth(int depth);
+    };
+
+    /// Writes spans as Chrome trace-event JSON: an object with a "traceEvents" array of complete ("X") events
+    class ChromeTraceWriter {
+    public:
+        /// Start the JSON document on the stream, which must outlive the writer
+        explicit ChromeTraceWriter(std::ostream &output);
+
+        ChromeTraceWriter(ChromeTraceWriter const &) = delete;
+
+        ChromeTraceWriter &operator=(ChromeTraceWriter const &) = delete;
+
+        /// Finishes the document
+        ~ChromeTraceWriter();
+
+        /// Write one span. Safe to call from several threads.
+        void Record(TraceEvent const &event);
+
+        /// A sink writing into this writer, to pass to Trace::SetSink
+        TraceSink Sink();
+
+        /// Close the "traceEvents" array and the document; later spans are dropped
+        void Finish();
+
+    private:
+        std::ostream &out;
+        std::mutex mutex;
+        bool first = true;
+        bool finished = false;
+    };
+
+#ifdef SURREALS_TRACE
+
+    /// Records a span from its construction to its destruction, if a sink is installed
+    class TraceScope {
+    public:
+        TraceScope(char const *name, Surreal const &a, Surreal const &b);
+
+        TraceScope(TraceScope const &) = delete;
+
+        TraceScope &operator=(TraceScope const &) = delete;
+
+        ~TraceScope();
+
+        /// Where the result came from, "computed" unless set
+        void Outcome(char const *outcome);
+
+    private:
+        bool active = false;
+        TraceEvent event;
+        static thread_local int depth;
+    };
+
+#define SURREALS_TRACE_SCOPE(span, name, a, b) ::surreals::TraceScope span(name, a, b)
+#define SURREALS_TRACE_OUTCOME(span, outcome) span.Outcome(outcome)
+
+#else
+
+#define SURREALS_TRACE_SCOPE(span, name, a, b) ((void) 0)
+#define SURREALS_TRACE_OUTCOME(span, outcome) ((void) 0)
+
+#endif
+
+}
+
+#endif //SURREALS_TRACE_H